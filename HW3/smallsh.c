@@ -15,10 +15,17 @@
 #include <sys/wait.h>
 #include <signal.h>
 #include <ctype.h>
+#include <spawn.h>  // posix_spawn for the fast launch path
+#include <errno.h>
+
+// Environment passed to spawned commands
+extern char **environ;
 
 // Constants defining maximum allowed input characters and arguments
 #define MAX_CHARS 2048
 #define MAX_ARGS 512
+#define PATH_CACHE_BUCKETS 64 // Buckets in the command path cache
+#define BG_HASH_BUCKETS 256  // Buckets in the background job table
 
 // Global Variables
 // 'fgOnly' flag indicates whether the shell is in foreground-only mode.
@@ -31,14 +38,44 @@ int lastStatus = 0;
 int lastSignal = 0;
 
 // Structure to represent a background process.
-// It contains the process ID and a pointer to the next background process in the list.
+// Entries live in a pid-keyed hash table so add, remove and lookup are O(1)
+// no matter how many jobs are outstanding.
 typedef struct bgProcess {
     pid_t pid;                // Process ID of the background process
-    struct bgProcess* next;   // Pointer to the next background process
+    struct bgProcess* next;   // Next process in the same hash bucket
 } bgProcess;
 
-// Head pointer for the linked list of background processes.
-bgProcess* bgList = NULL;
+// Hash table of live background processes, keyed by pid.
+bgProcess* bgJobs[BG_HASH_BUCKETS] = {0};
+
+// Structure describing one reaped child, as written to the self-pipe.
+typedef struct ChildEvent {
+    pid_t pid;  // The reaped process
+    int status; // Its waitpid() status
+} ChildEvent;
+
+// Self-pipe carrying ChildEvent records from the SIGCHLD handler to the
+// main loop. A write end under PIPE_BUF is atomic, so the handler needs no
+// locking; the read end is nonblocking so draining never stalls the prompt.
+int sigchldPipe[2] = { -1, -1 };
+
+// Structure for one entry in the command path cache.
+// It maps a command name to the absolute path execvp-style PATH probing found.
+typedef struct PathCacheEntry {
+    char* name;                   // Command name as typed
+    char* path;                   // Resolved absolute path
+    struct PathCacheEntry* next;  // Next entry in the same bucket
+} PathCacheEntry;
+
+// Hash table of resolved command paths, plus the PATH value it was built
+// against so a PATH change invalidates the whole cache.
+PathCacheEntry* pathCache[PATH_CACHE_BUCKETS] = {0};
+char* pathCacheEnv = NULL;
+
+// Per-line arena the "$$" expansion writes into and tokenization slices
+// with in-place NUL termination. One command line lives here at a time, so
+// parsing allocates nothing on the heap in the steady state.
+char lineArena[MAX_CHARS];
 
 // Structure to represent a parsed command.
 // It contains arguments, input/output redirection files, and a flag for background execution.
@@ -51,16 +88,19 @@ typedef struct Command {
 
 // Function Prototypes
 void handleSIGTSTP(int signo);            // Handler for SIGTSTP (Ctrl-Z) signal
+void handleSIGCHLD(int signo);            // Handler reaping children into the self-pipe
 void setupSignalHandlers();               // Sets up the shell's signal handlers
 char* getInput();                         // Retrieves user input from the command line
 int isBlankOrComment(char* input);        // Checks if the input line is blank or a comment
-char* expandPID(char* input);             // Expands instances of "$$" to the shell's PID
+char* expandPID(char* input);             // Expands "$$" into the per-line arena
 int handleBuiltIn(Command* cmd);          // Processes built-in commands (exit, cd, status)
-void handleRedirection(Command* cmd, int background); // Handles input/output redirection for commands
+unsigned int hashString(const char* str); // Hashes a string for the path cache
+void clearPathCache();                    // Drops every cached path resolution
+const char* resolveCommandPath(const char* name); // Resolves a command through the cache
 void executeCommand(Command* cmd);        // Executes non-built-in commands
-void addBgProcess(pid_t pid);             // Adds a process to the background process list
-void removeBgProcess(pid_t pid);          // Removes a process from the background process list
-void checkBgProcesses();                  // Checks the status of background processes and updates the list
+void addBgProcess(pid_t pid);             // Adds a process to the background job table
+int removeBgProcess(pid_t pid);           // Removes a process from the background job table
+void checkBgProcesses();                  // Reports jobs reaped by the SIGCHLD handler
 
 // Signal Handlers
 
@@ -87,6 +127,31 @@ void handleSIGTSTP(int signo) {
     }
 }
 
+/**
+ * handleSIGCHLD - Reaps terminated children the moment they exit.
+ *
+ * Runs waitpid(WNOHANG) until no more children are ready and writes one
+ * ChildEvent per reaped pid into the self-pipe. Everything here is
+ * async-signal-safe; the main loop drains the pipe at the prompt. SIGCHLD
+ * is blocked while a foreground child runs, so only background jobs are
+ * ever reaped here.
+ *
+ * @signo: The signal number received.
+ */
+void handleSIGCHLD(int signo) {
+    (void)signo;
+    int savedErrno = errno; // waitpid and write may clobber errno
+
+    ChildEvent event;
+    while ((event.pid = waitpid(-1, &event.status, WNOHANG)) > 0) {
+        // A full pipe drops the record; the job table entry then lingers
+        // until exit, which only costs a missed completion message
+        write(sigchldPipe[1], &event, sizeof(event));
+    }
+
+    errno = savedErrno;
+}
+
 /**
  * setupSignalHandlers - Configures the shell's signal handling behavior.
  * - Ignores SIGINT (Ctrl-C) to prevent the shell itself from being terminated.
@@ -107,27 +172,45 @@ void setupSignalHandlers() {
     sigfillset(&SIGTSTP_action.sa_mask);        // Block all signals during handler
     SIGTSTP_action.sa_flags = SA_RESTART;       // Restart interrupted system calls
     sigaction(SIGTSTP, &SIGTSTP_action, NULL);   // Apply the action
+
+    // Create the self-pipe before SIGCHLD can fire; both ends nonblocking
+    // so neither the handler nor the prompt can stall on it
+    if (pipe(sigchldPipe) == -1) {
+        perror("pipe");
+        exit(1);
+    }
+    fcntl(sigchldPipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(sigchldPipe[1], F_SETFL, O_NONBLOCK);
+
+    // Configure SIGCHLD to reap children into the self-pipe as they exit
+    struct sigaction SIGCHLD_action = {0};
+    SIGCHLD_action.sa_handler = handleSIGCHLD; // Reap into the self-pipe
+    sigfillset(&SIGCHLD_action.sa_mask);        // Block all signals during handler
+    SIGCHLD_action.sa_flags = SA_RESTART;       // Restart interrupted system calls
+    sigaction(SIGCHLD, &SIGCHLD_action, NULL);   // Apply the action
 }
 
 /**
  * getInput - Prompts the user and retrieves a line of input from the command line.
  *
+ * The getline() buffer is static and reused for every prompt, so reading a
+ * line allocates only on the first call (or when a longer line forces a grow).
+ *
  * Returns:
- *   A dynamically allocated string containing the user's input.
+ *   The input line, valid until the next call.
  *   Returns NULL if an error occurs or EOF is encountered.
  */
 char* getInput() {
-    char* input = NULL;    // Pointer to store the input string
-    size_t buffer = 0;     // Size of the buffer (managed by getline)
+    static char* input = NULL;  // Line buffer, reused across prompts
+    static size_t buffer = 0;   // Size of the buffer (managed by getline)
     printf(": ");          // Display the command prompt
     fflush(stdout);       // Ensure the prompt is displayed immediately
 
-    // Use getline to read an entire line from stdin, allocating memory as needed
+    // getline grows the buffer on first use, then reuses it
     ssize_t nread = getline(&input, &buffer, stdin);
     if (nread == -1) {
         // Handle EOF or read error
         clearerr(stdin); // Clear the error indicator
-        free(input);     // Free any allocated memory
         return NULL;     // Return NULL to indicate no input
     }
     return input; // Return the user's input
@@ -154,36 +237,37 @@ int isBlankOrComment(char* input) {
  *
  * @input: The original input string containing potential "$$" sequences.
  *
+ * The expansion writes into the per-line arena through a cursor, so it does
+ * no heap allocation and runs in one pass. Output beyond MAX_CHARS - 1 is
+ * truncated.
+ *
  * Returns:
- *   A new dynamically allocated string with "$$" expanded to the PID.
- *   The caller is responsible for freeing the returned string.
+ *   The expanded line in lineArena, valid until the next command line.
  */
 char* expandPID(char* input) {
-    char* ptr = input;                             // Pointer to traverse the input string
-    char* result = malloc(MAX_CHARS);              // Allocate memory for the expanded string
-    if (!result) {                                 // Check for successful allocation
-        perror("malloc");                          // Print error message if allocation fails
-        exit(1);                                   // Terminate the program
+    // The PID never changes, so format it once
+    static char pidStr[20];
+    static size_t pidLen = 0;
+    if (pidLen == 0) {
+        pidLen = sprintf(pidStr, "%d", getpid());
     }
-    result[0] = '\0';                               // Initialize the result string as empty
-
-    // Loop through the input string, searching for "$$"
-    while ((ptr = strstr(ptr, "$$")) != NULL) {
-        // Concatenate the segment before "$$" to the result
-        strncat(result, input, ptr - input);
-
-        // Convert the PID to a string and concatenate it to the result
-        char pidStr[20];
-        sprintf(pidStr, "%d", getpid());
-        strcat(result, pidStr);
 
-        ptr += 2; // Move past the "$$" sequence
-        input = ptr; // Update the input pointer to the new position
+    size_t out = 0; // Write cursor into the arena
+    while (*input != '\0' && out < MAX_CHARS - 1) {
+        if (input[0] == '$' && input[1] == '$') {
+            // Copy the PID in place of the "$$" sequence
+            size_t room = MAX_CHARS - 1 - out;
+            size_t n = pidLen < room ? pidLen : room;
+            memcpy(lineArena + out, pidStr, n);
+            out += n;
+            input += 2; // Move past the "$$" sequence
+        }
+        else {
+            lineArena[out++] = *input++;
+        }
     }
-
-    // Concatenate any remaining part of the input string after the last "$$"
-    strcat(result, input);
-    return result; // Return the expanded string
+    lineArena[out] = '\0';
+    return lineArena; // Return the expanded line
 }
 
 /**
@@ -197,18 +281,16 @@ char* expandPID(char* input) {
 int handleBuiltIn(Command* cmd) {
     // Handle the 'exit' built-in command
     if (strcmp(cmd->args[0], "exit") == 0) {
-        // Iterate through the background process list and terminate each process
-        bgProcess* current = bgList;
-        while (current != NULL) {
-            kill(current->pid, SIGTERM); // Send SIGTERM to terminate the process
-            current = current->next;     // Move to the next process
-        }
-
-        // Free the linked list of background processes
-        while (bgList != NULL) {
-            bgProcess* temp = bgList;     // Temporary pointer to current process
-            bgList = bgList->next;        // Move the head to the next process
-            free(temp);                   // Free the memory of the terminated process
+        // Terminate and free every background process in the job table
+        for (int i = 0; i < BG_HASH_BUCKETS; i++) {
+            bgProcess* current = bgJobs[i];
+            while (current != NULL) {
+                bgProcess* temp = current;
+                kill(current->pid, SIGTERM); // Send SIGTERM to terminate the process
+                current = current->next;      // Move to the next process
+                free(temp);                   // Free the job entry
+            }
+            bgJobs[i] = NULL;
         }
 
         exit(0); // Terminate the shell
@@ -248,232 +330,316 @@ int handleBuiltIn(Command* cmd) {
 }
 
 /**
- * handleRedirection - Sets up input and output redirection for a command.
+ * addBgProcess - Adds a new background process to the job table.
  *
- * @cmd: Pointer to the Command structure containing the parsed command.
- * @background: Flag indicating if the command is to be executed in the background.
+ * @pid: The process ID of the background process to add.
+ */
+void addBgProcess(pid_t pid) {
+    // Allocate a new entry and insert it at the head of its bucket
+    bgProcess* newNode = malloc(sizeof(bgProcess));
+    unsigned int bucket = (unsigned int)pid % BG_HASH_BUCKETS;
+    newNode->pid = pid;            // Set the PID
+    newNode->next = bgJobs[bucket]; // Insert at the beginning of the bucket
+    bgJobs[bucket] = newNode;       // Update the bucket head
+}
+
+/**
+ * removeBgProcess - Removes a background process from the job table.
+ *
+ * @pid: The process ID of the background process to remove.
  *
- * This function uses dup2() to redirect stdin and stdout to the specified files.
- * If the command is a background process and no redirection is specified,
- * it redirects stdin and/or stdout to /dev/null.
+ * Returns:
+ *   1 if the pid was found and removed, 0 otherwise.
  */
-void handleRedirection(Command* cmd, int background) {
-    // Handle Input Redirection
-    if (cmd->inputFile != NULL) {
-        // Open the input file for reading only
-        int inputFD = open(cmd->inputFile, O_RDONLY);
-        if (inputFD == -1) {
-            // If opening fails, print an error and exit the child process
-            fprintf(stderr, "cannot open %s for input\n", cmd->inputFile);
-            exit(1);
-        }
-        // Duplicate the input file descriptor to stdin (file descriptor 0)
-        if (dup2(inputFD, 0) == -1) {
-            perror("dup2"); // Print error if dup2 fails
-            exit(1);
-        }
-        close(inputFD); // Close the original file descriptor as it's no longer needed
-    }
-    else if (background) {
-        // If in background and no input redirection, redirect stdin to /dev/null
-        int devNull = open("/dev/null", O_RDONLY);
-        if (devNull == -1) {
-            perror("open /dev/null"); // Print error if opening fails
-            exit(1);
-        }
-        if (dup2(devNull, 0) == -1) {
-            perror("dup2"); // Print error if dup2 fails
-            exit(1);
+int removeBgProcess(pid_t pid) {
+    unsigned int bucket = (unsigned int)pid % BG_HASH_BUCKETS;
+    bgProcess** current = &bgJobs[bucket]; // Pointer to the current node's pointer
+    while (*current) {              // Walk the (short) bucket chain
+        if ((*current)->pid == pid) { // Check if the current node matches the PID
+            bgProcess* temp = *current; // Temporary pointer to the current node
+            *current = (*current)->next; // Remove the node from the bucket
+            free(temp);                   // Free the memory of the removed node
+            return 1;                     // Found and removed
         }
-        close(devNull); // Close the original file descriptor
+        current = &((*current)->next); // Move to the next node
     }
+    return 0; // Not a known background job
+}
 
-    // Handle Output Redirection
-    if (cmd->outputFile != NULL) {
-        // Open the output file for writing only, create it if it doesn't exist, truncate if it does
-        int outputFD = open(cmd->outputFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
-        if (outputFD == -1) {
-            // If opening fails, print an error and exit the child process
-            fprintf(stderr, "cannot open %s for output\n", cmd->outputFile);
-            exit(1);
-        }
-        // Duplicate the output file descriptor to stdout (file descriptor 1)
-        if (dup2(outputFD, 1) == -1) {
-            perror("dup2"); // Print error if dup2 fails
-            exit(1);
+/**
+ * checkBgProcesses - Reports background processes the handler has reaped.
+ *
+ * The SIGCHLD handler already did the waitpid() work the moment each child
+ * exited; this just drains the self-pipe and prints one message per
+ * completed job, so prompt latency does not depend on how many jobs are
+ * outstanding.
+ */
+void checkBgProcesses() {
+    ChildEvent event;
+    while (read(sigchldPipe[0], &event, sizeof(event)) == (ssize_t)sizeof(event)) {
+        // Only report pids we launched into the background
+        if (!removeBgProcess(event.pid)) {
+            continue;
         }
-        close(outputFD); // Close the original file descriptor
-    }
-    else if (background) {
-        // If in background and no output redirection, redirect stdout to /dev/null
-        int devNull = open("/dev/null", O_WRONLY);
-        if (devNull == -1) {
-            perror("open /dev/null"); // Print error if opening fails
-            exit(1);
+        if (WIFSIGNALED(event.status)) {
+            printf("background pid %d is done: terminated by signal %d\n",
+                   event.pid, WTERMSIG(event.status));
         }
-        if (dup2(devNull, 1) == -1) {
-            perror("dup2"); // Print error if dup2 fails
-            exit(1);
+        else {
+            printf("background pid %d is done: exit value %d\n",
+                   event.pid, WEXITSTATUS(event.status));
         }
-        close(devNull); // Close the original file descriptor
+        fflush(stdout); // Ensure the message is displayed immediately
     }
 }
 
 /**
- * addBgProcess - Adds a new background process to the background process list.
+ * hashString - Computes a hash of a string for the command path cache.
  *
- * @pid: The process ID of the background process to add.
+ * @str: The string to hash.
+ *
+ * Returns:
+ *   The hash value (djb2).
  */
-void addBgProcess(pid_t pid) {
-    // Allocate memory for a new bgProcess node
-    bgProcess* newNode = malloc(sizeof(bgProcess));
-    newNode->pid = pid;       // Set the PID
-    newNode->next = bgList;   // Insert at the beginning of the list
-    bgList = newNode;         // Update the head of the list
+unsigned int hashString(const char* str) {
+    unsigned int hash = 5381;
+    while (*str) {
+        hash = hash * 33 + (unsigned char)*str++;
+    }
+    return hash;
 }
 
 /**
- * removeBgProcess - Removes a background process from the background process list.
+ * clearPathCache - Frees every entry in the command path cache.
  *
- * @pid: The process ID of the background process to remove.
- *
- * This function traverses the linked list to find and remove the specified process.
+ * Called when PATH changes, since every cached resolution may be stale.
  */
-void removeBgProcess(pid_t pid) {
-    bgProcess** current = &bgList; // Pointer to the current node's pointer
-    while (*current) {              // Traverse the list
-        if ((*current)->pid == pid) { // Check if the current node matches the PID
-            bgProcess* temp = *current; // Temporary pointer to the current node
-            *current = (*current)->next; // Remove the node from the list
-            free(temp);                   // Free the memory of the removed node
-            return;                       // Exit after removal
+void clearPathCache() {
+    for (int i = 0; i < PATH_CACHE_BUCKETS; i++) {
+        PathCacheEntry* entry = pathCache[i];
+        while (entry != NULL) {
+            PathCacheEntry* temp = entry;
+            entry = entry->next;
+            free(temp->name);
+            free(temp->path);
+            free(temp);
         }
-        current = &((*current)->next); // Move to the next node
+        pathCache[i] = NULL;
     }
 }
 
 /**
- * checkBgProcesses - Checks the status of all background processes.
+ * resolveCommandPath - Resolves a command name to an executable path.
+ *
+ * @name: The command name as typed.
+ *
+ * Names containing a slash are returned as-is, like execvp. Otherwise the
+ * cache is consulted first; on a miss the PATH directories are probed once
+ * and the result is remembered, so repeated commands skip the directory
+ * probing entirely. A changed PATH drops the whole cache first.
  *
- * This function iterates through the background process list and uses waitpid()
- * with the WNOHANG option to check if any background processes have completed.
- * If a process has completed, it prints a message and removes the process from the list.
+ * Returns:
+ *   The resolved path (owned by the cache, or the name itself), or NULL if
+ *   the command was not found on PATH.
  */
-void checkBgProcesses() {
-    bgProcess* current = bgList; // Start from the head of the list
-    bgProcess* prev = NULL;      // Pointer to the previous node
-
-    while (current != NULL) {
-        // Check if the background process has terminated without blocking
-        pid_t result = waitpid(current->pid, NULL, WNOHANG);
-        if (result > 0) {
-            // If the process has terminated, inform the user
-            printf("background pid %d is done: exit value 0\n", current->pid);
-            fflush(stdout); // Ensure the message is displayed immediately
+const char* resolveCommandPath(const char* name) {
+    // A slash bypasses PATH search entirely
+    if (strchr(name, '/') != NULL) {
+        return name;
+    }
 
-            // Remove the process from the list
-            if (prev == NULL) {
-                // If it's the first node, update the head
-                bgList = current->next;
-                free(current); // Free the memory of the terminated process
-                current = bgList; // Move to the next process
-            }
-            else {
-                // If it's not the first node, bypass the terminated node
-                prev->next = current->next;
-                free(current);      // Free the memory of the terminated process
-                current = prev->next; // Move to the next process
-            }
+    // Rebuild against the current PATH if it changed since the last lookup
+    char* currentPath = getenv("PATH");
+    if (currentPath == NULL) {
+        currentPath = "";
+    }
+    if (pathCacheEnv == NULL || strcmp(pathCacheEnv, currentPath) != 0) {
+        clearPathCache();
+        free(pathCacheEnv);
+        pathCacheEnv = strdup(currentPath);
+    }
+
+    // Cache hit: the common case for repeated commands
+    unsigned int bucket = hashString(name) % PATH_CACHE_BUCKETS;
+    for (PathCacheEntry* entry = pathCache[bucket]; entry != NULL; entry = entry->next) {
+        if (strcmp(entry->name, name) == 0) {
+            return entry->path;
+        }
+    }
+
+    // Miss: probe each PATH directory the way execvp would
+    char candidate[MAX_CHARS];
+    const char* p = currentPath;
+    while (1) {
+        const char* end = strchr(p, ':');
+        size_t dirLen = end != NULL ? (size_t)(end - p) : strlen(p);
+        if (dirLen == 0) {
+            // An empty PATH entry means the current directory
+            snprintf(candidate, sizeof(candidate), "./%s", name);
         }
         else {
-            // If the process is still running, move to the next one
-            prev = current;
-            current = current->next;
+            snprintf(candidate, sizeof(candidate), "%.*s/%s", (int)dirLen, p, name);
+        }
+        if (access(candidate, X_OK) == 0) {
+            // Remember the resolution for next time
+            PathCacheEntry* entry = malloc(sizeof(PathCacheEntry));
+            entry->name = strdup(name);
+            entry->path = strdup(candidate);
+            entry->next = pathCache[bucket];
+            pathCache[bucket] = entry;
+            return entry->path;
+        }
+        if (end == NULL) {
+            break;
         }
+        p = end + 1;
     }
+    return NULL; // Not found; nothing is cached so a later install is seen
 }
 
 /**
- * executeCommand - Executes non-built-in commands by forking a child process.
+ * executeCommand - Executes non-built-in commands via posix_spawn.
  *
  * @cmd: Pointer to the Command structure containing the parsed command.
  *
- * This function handles the creation of child processes, setting up signal
- * handling in children, performing I/O redirection, and executing the command.
+ * The command name resolves through the path cache, redirection targets are
+ * opened in the shell (so failures are reported without creating a child),
+ * and posix_spawn launches the program without duplicating the shell's page
+ * tables the way fork() does. Foreground children get the default SIGINT
+ * action back through the spawn attributes; SIGTSTP is briefly set to
+ * ignored around the spawn so children inherit that disposition across exec.
  * It also manages foreground and background execution behavior.
  */
 void executeCommand(Command* cmd) {
-    pid_t spawnPid = fork(); // Create a new child process
-    int childStatus;         // Variable to store the child's exit status
-
-    switch(spawnPid) {
-        case -1:
-            // If fork() fails, print an error and terminate
-            perror("fork");
-            exit(1);
-            break;
-        case 0:
-            // In the child process
-
-            // Handle Signals in the child process
-            if (cmd->background) {
-                // For background processes, ignore SIGINT (Ctrl-C)
-                struct sigaction SIGINT_child = {0};
-                SIGINT_child.sa_handler = SIG_IGN; // Ignore SIGINT
-                sigfillset(&SIGINT_child.sa_mask);  // Block all signals during handler
-                SIGINT_child.sa_flags = 0;          // No special flags
-                sigaction(SIGINT, &SIGINT_child, NULL); // Apply the action
-            }
-            else {
-                // For foreground processes, use the default SIGINT behavior
-                struct sigaction SIGINT_child = {0};
-                SIGINT_child.sa_handler = SIG_DFL;  // Default handler
-                sigfillset(&SIGINT_child.sa_mask);   // Block all signals during handler
-                SIGINT_child.sa_flags = 0;           // No special flags
-                sigaction(SIGINT, &SIGINT_child, NULL); // Apply the action
-            }
+    int childStatus; // Variable to store the child's exit status
+
+    // Resolve the program before spawning anything
+    const char* path = resolveCommandPath(cmd->args[0]);
+    if (path == NULL) {
+        errno = ENOENT;
+        perror(cmd->args[0]); // Same report the old execvp failure produced
+        lastStatus = 1;
+        lastSignal = 0;
+        return;
+    }
 
-            // Ignore SIGTSTP (Ctrl-Z) in child processes
-            struct sigaction SIGTSTP_child = {0};
-            SIGTSTP_child.sa_handler = SIG_IGN; // Ignore SIGTSTP
-            sigfillset(&SIGTSTP_child.sa_mask);  // Block all signals during handler
-            SIGTSTP_child.sa_flags = 0;          // No special flags
-            sigaction(SIGTSTP, &SIGTSTP_child, NULL); // Apply the action
-
-            // Handle input and output redirection
-            handleRedirection(cmd, cmd->background);
-
-            // Execute the command using execvp, which searches the PATH environment variable
-            if (execvp(cmd->args[0], cmd->args) == -1) {
-                // If execvp fails, print an error and terminate the child process
-                perror(cmd->args[0]);
-                exit(1);
-            }
-            break;
-        default:
-            // In the parent process
-            if (!cmd->background) {
-                // If the command is to be run in the foreground, wait for it to complete
-                pid_t childPid = waitpid(spawnPid, &childStatus, 0); // Wait for the specific child
-                if (WIFEXITED(childStatus)) {
-                    // If the child exited normally, store the exit status
-                    lastStatus = WEXITSTATUS(childStatus);
-                    lastSignal = 0; // No signal termination
-                }
-                else if (WIFSIGNALED(childStatus)) {
-                    // If the child was terminated by a signal, store the signal number
-                    lastSignal = WTERMSIG(childStatus);
-                    printf("terminated by signal %d\n", lastSignal); // Inform the user
-                    fflush(stdout); // Ensure the message is displayed immediately
-                }
-            }
-            else {
-                // If the command is to be run in the background, do not wait
-                printf("background pid is %d\n", spawnPid); // Inform the user of the background PID
-                fflush(stdout); // Ensure the message is displayed immediately
-                addBgProcess(spawnPid); // Add the background process to the list
-            }
-            break;
+    // Open redirection targets (or /dev/null for background commands) here
+    // in the shell, mirroring handleRedirection()'s rules
+    int inputFD = -1;
+    int outputFD = -1;
+    if (cmd->inputFile != NULL) {
+        inputFD = open(cmd->inputFile, O_RDONLY);
+        if (inputFD == -1) {
+            fprintf(stderr, "cannot open %s for input\n", cmd->inputFile);
+            lastStatus = 1;
+            lastSignal = 0;
+            return;
+        }
+    }
+    else if (cmd->background) {
+        inputFD = open("/dev/null", O_RDONLY);
+    }
+    if (cmd->outputFile != NULL) {
+        outputFD = open(cmd->outputFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (outputFD == -1) {
+            fprintf(stderr, "cannot open %s for output\n", cmd->outputFile);
+            if (inputFD != -1) close(inputFD);
+            lastStatus = 1;
+            lastSignal = 0;
+            return;
+        }
+    }
+    else if (cmd->background) {
+        outputFD = open("/dev/null", O_WRONLY);
+    }
+
+    // Describe the redirections for the child
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    if (inputFD != -1) {
+        posix_spawn_file_actions_adddup2(&actions, inputFD, 0);
+    }
+    if (outputFD != -1) {
+        posix_spawn_file_actions_adddup2(&actions, outputFD, 1);
+    }
+
+    // Foreground children take the default SIGINT action again; background
+    // children inherit the shell's ignore, exactly like the fork path did
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    if (!cmd->background) {
+        sigset_t defaultSignals;
+        sigemptyset(&defaultSignals);
+        sigaddset(&defaultSignals, SIGINT);
+        posix_spawnattr_setsigdefault(&attr, &defaultSignals);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+    }
+
+    // Children must ignore SIGTSTP, and an ignored disposition is the only
+    // one that survives exec: ignore it here for the spawn, then restore
+    // the foreground-only toggle handler
+    struct sigaction ignoreTSTP = {0}, savedTSTP;
+    ignoreTSTP.sa_handler = SIG_IGN;
+    sigaction(SIGTSTP, &ignoreTSTP, &savedTSTP);
+
+    // Keep the SIGCHLD handler away from foreground children: with the
+    // signal blocked from before the spawn until after the blocking wait,
+    // only the waitpid() below can reap this child
+    sigset_t chldMask, prevMask;
+    sigemptyset(&chldMask);
+    sigaddset(&chldMask, SIGCHLD);
+    if (!cmd->background) {
+        sigprocmask(SIG_BLOCK, &chldMask, &prevMask);
+        // The blocked mask survives exec, so hand the child the pre-block
+        // mask or it would start with SIGCHLD blocked and its own waits
+        // (e.g. a shell script's wait builtin) would hang
+        posix_spawnattr_setsigmask(&attr, &prevMask);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+    }
+
+    pid_t spawnPid;
+    int spawnErr = posix_spawn(&spawnPid, path, &actions, &attr, cmd->args, environ);
+
+    sigaction(SIGTSTP, &savedTSTP, NULL); // Restore the toggle handler
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    if (inputFD != -1) close(inputFD);
+    if (outputFD != -1) close(outputFD);
+
+    if (spawnErr != 0) {
+        // No child was created; report the failure like the old exec path
+        if (!cmd->background) {
+            sigprocmask(SIG_SETMASK, &prevMask, NULL);
+        }
+        errno = spawnErr;
+        perror(cmd->args[0]);
+        lastStatus = 1;
+        lastSignal = 0;
+        return;
+    }
+
+    // In the parent process
+    if (!cmd->background) {
+        // If the command is to be run in the foreground, wait for it to complete
+        waitpid(spawnPid, &childStatus, 0); // Wait for the specific child
+        sigprocmask(SIG_SETMASK, &prevMask, NULL); // Let SIGCHLD reap again
+        if (WIFEXITED(childStatus)) {
+            // If the child exited normally, store the exit status
+            lastStatus = WEXITSTATUS(childStatus);
+            lastSignal = 0; // No signal termination
+        }
+        else if (WIFSIGNALED(childStatus)) {
+            // If the child was terminated by a signal, store the signal number
+            lastSignal = WTERMSIG(childStatus);
+            printf("terminated by signal %d\n", lastSignal); // Inform the user
+            fflush(stdout); // Ensure the message is displayed immediately
+        }
+    }
+    else {
+        // If the command is to be run in the background, do not wait
+        printf("background pid is %d\n", spawnPid); // Inform the user of the background PID
+        fflush(stdout); // Ensure the message is displayed immediately
+        addBgProcess(spawnPid); // Add the background process to the job table
     }
 }
 
@@ -485,19 +651,17 @@ int main() {
         // Check if any background processes have completed
         checkBgProcesses();
 
-        // Retrieve user input
+        // Retrieve user input (the line buffer is reused between prompts)
         char* input = getInput();
         if (input == NULL) continue; // If no input, prompt again
 
         // Handle blank lines and comments by ignoring them
         if (isBlankOrComment(input)) {
-            free(input); // Free the memory allocated by getline
             continue;    // Skip to the next iteration of the loop
         }
 
-        // Expand instances of "$$" to the shell's PID
+        // Expand instances of "$$" to the shell's PID, into the line arena
         char* expandedInput = expandPID(input);
-        free(input); // Free the original input string as it's no longer needed
 
         // Parse the expanded input into the Command structure
         Command cmd = {0}; // Initialize the Command structure to zero
@@ -505,22 +669,24 @@ int main() {
         char* token = strtok_r(expandedInput, " \n", &saveptr); // Tokenize the input by spaces and newlines
         int argCount = 0;   // Counter for the number of arguments
 
+        // Tokens are slices of the arena: strtok_r NUL-terminates in place,
+        // so arguments and filenames need no duplication
         while (token != NULL && argCount < MAX_ARGS) { // Loop through each token
             if (strcmp(token, "<") == 0) { // Input redirection detected
                 token = strtok_r(NULL, " \n", &saveptr); // Get the filename for input redirection
                 if (token != NULL) {
-                    cmd.inputFile = strdup(token); // Duplicate the token and store as inputFile
+                    cmd.inputFile = token; // Points into the arena
                 }
             }
             else if (strcmp(token, ">") == 0) { // Output redirection detected
                 token = strtok_r(NULL, " \n", &saveptr); // Get the filename for output redirection
                 if (token != NULL) {
-                    cmd.outputFile = strdup(token); // Duplicate the token and store as outputFile
+                    cmd.outputFile = token; // Points into the arena
                 }
             }
             else {
-                // Regular argument; store it in the args array
-                cmd.args[argCount++] = strdup(token); // Duplicate the token and add to args
+                // Regular argument; store the arena slice in the args array
+                cmd.args[argCount++] = token;
             }
             token = strtok_r(NULL, " \n", &saveptr); // Get the next token
         }
@@ -528,7 +694,6 @@ int main() {
         // Check if the last argument is "&" indicating background execution
         if (argCount > 0 && strcmp(cmd.args[argCount - 1], "&") == 0) {
             cmd.background = 1;             // Set the background flag
-            free(cmd.args[argCount - 1]);  // Free the memory allocated for "&"
             cmd.args[argCount - 1] = NULL;  // Remove "&" from the args array
             argCount--;                      // Decrement the argument count
         }
@@ -549,14 +714,8 @@ int main() {
             executeCommand(&cmd);
         }
 
-        // Free dynamically allocated memory for arguments and redirection files
-        
-        for (int i = 0; i < argCount; i++) {
-            free(cmd.args[i]); // Free each argument string
-        }
-        if (cmd.inputFile) free(cmd.inputFile);   // Free inputFile if it was set
-        if (cmd.outputFile) free(cmd.outputFile); // Free outputFile if it was set
-        free(expandedInput); // Free the expanded input string
+        // Nothing to free: arguments and filenames are slices of the line
+        // arena, which the next command line simply overwrites
     }
 
     return 0; // This line is technically unreachable due to the infinite loop
@@ -23,9 +23,10 @@
  *
  * Usage:
  * ------
- * Run the server by specifying a listening port:
+ * Run the server by specifying a listening port, and optionally a preforked
+ * worker pool size (default is one forked child per connection):
  *
- *     ./dec_server <listening_port>
+ *     ./dec_server <listening_port> [prefork_workers|epoll]
  *
  * Example:
  *
@@ -50,9 +51,460 @@
 #include <errno.h>
 #include <arpa/inet.h>
 #include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <stdint.h>
 
+#include "otp_kernel.h"
+
+#define MAX_PREFORK_WORKERS 64 // Upper bound on the preforked worker pool
 #define MAX_CONNECTIONS 5    // Maximum number of queued connections
-#define BUFFER_SIZE 1024      // Buffer size for data transmission
+#define BUFFER_SIZE 1024
+#define STREAM_CHUNK_SIZE 4096  // Payload bytes per streamed frame
+#define STREAM_MODE_SENTINEL -1 // Length value announcing the chunked protocol
+#define FRAME_MAGIC 0x31434544 /* "DEC1" little-endian */ // Leads the single-round-trip framed handshake
+#define KEYSTORE_PUT_MAGIC 0x4B434544 /* "DECK" */ // Frame uploading a named key
+#define KEYSTORE_REF_MAGIC 0x52434544 /* "DECR" */ // Frame referencing a stored key
+#define KEYSTORE_DIR "keystore"   // Where uploaded keys live, shared by both servers
+#define KEYSTORE_NAME_MAX 64      // Longest accepted key name
+
+/**
+ * @brief Serves one connection speaking the chunked streaming protocol.
+ *
+ * The client announces this mode by sending STREAM_MODE_SENTINEL where the
+ * legacy protocol carries the total ciphertext length. After that the
+ * connection carries frames: an int payload length (1..STREAM_CHUNK_SIZE,
+ * or 0 to finish), that many ciphertext bytes, and that many key bytes.
+ * Each frame is processed and its result sent back immediately, so
+ * per-connection memory is bounded by the chunk size no matter how large
+ * the job is, and transfer overlaps with compute.
+ *
+ * @param connection_fd File descriptor for the connected client socket.
+ * @return int 0 on success, nonzero on protocol or I/O failure.
+ */
+int handle_stream(int connection_fd) {
+    char text[STREAM_CHUNK_SIZE];
+    char key[STREAM_CHUNK_SIZE];
+    char result[STREAM_CHUNK_SIZE];
+
+    while (1) {
+        // Read the frame length; 0 marks a clean end of stream
+        int chunk_len;
+        ssize_t recv_ret = recv(connection_fd, &chunk_len, sizeof(int), MSG_WAITALL);
+        if (recv_ret < (ssize_t)sizeof(int)) {
+            fprintf(stderr, "dec_server error: failed to receive chunk length\n");
+            close(connection_fd);
+            return 1;
+        }
+        if (chunk_len == 0) {
+            break; // Stream complete
+        }
+        if (chunk_len < 0 || chunk_len > STREAM_CHUNK_SIZE) {
+            fprintf(stderr, "dec_server error: invalid chunk length %d\n", chunk_len);
+            close(connection_fd);
+            return 1;
+        }
+
+        // Read the frame's ciphertext and key payloads
+        int total_received = 0;
+        while (total_received < chunk_len) {
+            ssize_t n = recv(connection_fd, text + total_received, chunk_len - total_received, 0);
+            if (n <= 0) {
+                fprintf(stderr, "dec_server error: failed to receive chunk ciphertext\n");
+                close(connection_fd);
+                return 1;
+            }
+            total_received += n;
+        }
+        total_received = 0;
+        while (total_received < chunk_len) {
+            ssize_t n = recv(connection_fd, key + total_received, chunk_len - total_received, 0);
+            if (n <= 0) {
+                fprintf(stderr, "dec_server error: failed to receive chunk key\n");
+                close(connection_fd);
+                return 1;
+            }
+            total_received += n;
+        }
+
+        // Process the frame and send the result straight back
+        otp_decrypt(result, text, key, chunk_len);
+        int total_sent = 0;
+        while (total_sent < chunk_len) {
+            ssize_t n = send(connection_fd, result + total_sent, chunk_len - total_sent, 0);
+            if (n < 0) {
+                fprintf(stderr, "dec_server error: failed to send chunk result\n");
+                close(connection_fd);
+                return 1;
+            }
+            total_sent += n;
+        }
+    }
+
+    close(connection_fd);
+    return 0;
+}
+
+/**
+ * @brief Receives exactly len bytes, looping over short reads.
+ *
+ * @param fd  The connected socket.
+ * @param buf Destination buffer.
+ * @param len Number of bytes to receive.
+ * @return int 0 on success, -1 on error or premature close.
+ */
+int recv_full(int fd, void *buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = recv(fd, (char *)buf + got, len - got, 0);
+        if (n <= 0) {
+            return -1;
+        }
+        got += n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Sends exactly len bytes, looping over short writes.
+ *
+ * @param fd  The connected socket.
+ * @param buf Source buffer.
+ * @param len Number of bytes to send.
+ * @return int 0 on success, -1 on error.
+ */
+int send_full(int fd, const void *buf, size_t len) {
+    size_t sent = 0;
+    while (sent < len) {
+        ssize_t n = send(fd, (const char *)buf + sent, len - sent, 0);
+        if (n < 0) {
+            return -1;
+        }
+        sent += n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Validates a key name and builds its path inside KEYSTORE_DIR.
+ *
+ * Names are limited to letters, digits, '.', '_' and '-', may not start
+ * with '.', and are capped at KEYSTORE_NAME_MAX characters, which rules
+ * out path traversal through the store.
+ *
+ * @param out      Buffer for the resulting path.
+ * @param out_size Size of the path buffer.
+ * @param name     The key name (not NUL-terminated).
+ * @param name_len Length of the key name.
+ * @return int 0 on success, -1 if the name is invalid.
+ */
+int keystore_path(char *out, size_t out_size, const char *name, int name_len) {
+    if (name_len < 1 || name_len > KEYSTORE_NAME_MAX || name[0] == '.') {
+        return -1;
+    }
+    for (int i = 0; i < name_len; i++) {
+        char c = name[i];
+        int ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                 (c >= '0' && c <= '9') || c == '.' || c == '_' || c == '-';
+        if (!ok) {
+            return -1;
+        }
+    }
+    int written = snprintf(out, out_size, "%s/%.*s", KEYSTORE_DIR, name_len, name);
+    return (written > 0 && (size_t)written < out_size) ? 0 : -1;
+}
+
+/**
+ * @brief Serves one key-upload frame: stores a named key on disk.
+ *
+ * The magic has already been consumed; the rest of the frame is the name
+ * length, the key length, the name and the key bytes. The key lands in
+ * KEYSTORE_DIR (shared with the other server, and visible to every
+ * forked worker through the filesystem) and the reply is one int status:
+ * 0 on success, -1 on a bad name or store failure.
+ *
+ * @param connection_fd File descriptor for the connected client socket.
+ * @return int 0 when the connection is still usable, 1 on socket failure.
+ */
+int handle_keystore_put(int connection_fd) {
+    int lengths[2];
+    if (recv_full(connection_fd, lengths, sizeof(lengths)) < 0) {
+        fprintf(stderr, "dec_server error: failed to receive key store header\n");
+        return 1;
+    }
+    int name_len = lengths[0];
+    int key_len = lengths[1];
+    if (name_len < 1 || name_len > KEYSTORE_NAME_MAX || key_len < 1) {
+        fprintf(stderr, "dec_server error: invalid key store lengths\n");
+        return 1;
+    }
+
+    char name[KEYSTORE_NAME_MAX + 1];
+    char *key = malloc(key_len);
+    if (key == NULL) {
+        fprintf(stderr, "dec_server error: memory allocation failed\n");
+        return 1;
+    }
+    if (recv_full(connection_fd, name, name_len) < 0 ||
+        recv_full(connection_fd, key, key_len) < 0) {
+        fprintf(stderr, "dec_server error: failed to receive key upload\n");
+        free(key);
+        return 1;
+    }
+
+    // Store the key; a failure is reported in the status, not fatal
+    int status = 0;
+    char path[KEYSTORE_NAME_MAX + sizeof(KEYSTORE_DIR) + 2];
+    if (keystore_path(path, sizeof(path), name, name_len) < 0) {
+        status = -1;
+    } else {
+        mkdir(KEYSTORE_DIR, 0700); // Fine if it already exists
+        int store_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        if (store_fd < 0) {
+            status = -1;
+        } else {
+            ssize_t written = 0;
+            while (written < key_len) {
+                ssize_t n = write(store_fd, key + written, key_len - written);
+                if (n < 0) {
+                    status = -1;
+                    break;
+                }
+                written += n;
+            }
+            close(store_fd);
+        }
+    }
+    free(key);
+
+    if (send_full(connection_fd, &status, sizeof(status)) < 0) {
+        fprintf(stderr, "dec_server error: failed to send key store status\n");
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Serves one stored-key request: ciphertext plus a key name and offset.
+ *
+ * The magic has already been consumed; the rest of the frame is the
+ * ciphertext length, the name length, the offset, the ciphertext and the
+ * name. The named key is mapped read-only from the store — the kernel
+ * shares those pages across every worker touching the same key — so
+ * only the ciphertext crosses the wire. The reply is an int status (0 on
+ * success, -1 if the key is missing or too short), then the bare result
+ * bytes on success.
+ *
+ * @param connection_fd File descriptor for the connected client socket.
+ * @return int 0 when the connection is still usable, 1 on socket failure.
+ */
+int handle_keystore_ref(int connection_fd) {
+    int header[3];
+    if (recv_full(connection_fd, header, sizeof(header)) < 0) {
+        fprintf(stderr, "dec_server error: failed to receive key store header\n");
+        return 1;
+    }
+    int text_len = header[0];
+    int name_len = header[1];
+    int offset = header[2];
+    if (text_len < 1 || name_len < 1 || name_len > KEYSTORE_NAME_MAX || offset < 0) {
+        fprintf(stderr, "dec_server error: invalid key store lengths\n");
+        return 1;
+    }
+
+    char name[KEYSTORE_NAME_MAX + 1];
+    char *text = malloc(text_len);
+    char *result = malloc(text_len);
+    if (text == NULL || result == NULL) {
+        fprintf(stderr, "dec_server error: memory allocation failed\n");
+        free(text);
+        free(result);
+        return 1;
+    }
+    if (recv_full(connection_fd, text, text_len) < 0 ||
+        recv_full(connection_fd, name, name_len) < 0) {
+        fprintf(stderr, "dec_server error: failed to receive stored-key request\n");
+        free(text);
+        free(result);
+        return 1;
+    }
+
+    // Map the named key read-only and run the kernel against the slice
+    int status = 0;
+    char path[KEYSTORE_NAME_MAX + sizeof(KEYSTORE_DIR) + 2];
+    char *map = MAP_FAILED;
+    size_t map_size = 0;
+    if (keystore_path(path, sizeof(path), name, name_len) < 0) {
+        status = -1;
+    } else {
+        int key_fd = open(path, O_RDONLY);
+        struct stat st;
+        if (key_fd < 0 || fstat(key_fd, &st) < 0 ||
+            (off_t)offset + text_len > st.st_size) {
+            status = -1;
+        } else {
+            map_size = st.st_size;
+            map = mmap(NULL, map_size, PROT_READ, MAP_SHARED, key_fd, 0);
+            if (map == MAP_FAILED) {
+                status = -1;
+            }
+        }
+        if (key_fd >= 0) {
+            close(key_fd);
+        }
+    }
+    if (status == 0) {
+        otp_decrypt(result, text, map + offset, text_len);
+    }
+    if (map != MAP_FAILED) {
+        munmap(map, map_size);
+    }
+    free(text);
+
+    // Status first, then the result bytes only on success
+    if (send_full(connection_fd, &status, sizeof(status)) < 0 ||
+        (status == 0 && send_full(connection_fd, result, text_len) < 0)) {
+        fprintf(stderr, "dec_server error: failed to send stored-key result\n");
+        free(result);
+        return 1;
+    }
+    free(result);
+    return 0;
+}
+
+/**
+ * @brief Serves one connection speaking the framed single-round-trip protocol.
+ *
+ * A framed client leads with FRAME_MAGIC instead of the identity string, so
+ * the magic itself authenticates the peer and no acknowledgment round trip
+ * is needed: the 12-byte header (magic, ciphertext length, key length) and
+ * both payloads arrive in one submission, and the only reply is the result
+ * bytes (the client already knows the length). Frames repeat back to back
+ * on one connection, so a batch client can pipeline many requests without
+ * reconnecting; the client closing its end terminates the loop.
+ *
+ * @param connection_fd File descriptor for the connected client socket.
+ * @return int 0 on success, nonzero on protocol or I/O failure.
+ */
+int handle_framed(int connection_fd) {
+    while (1) {
+    // Read the magic naming the operation. A clean close here means the
+    // client has no more frames to pipeline
+    unsigned int magic;
+    ssize_t recv_ret = recv(connection_fd, &magic, sizeof(magic), MSG_WAITALL);
+    if (recv_ret == 0) {
+        close(connection_fd);
+        return 0;
+    }
+    if (recv_ret < (ssize_t)sizeof(magic)) {
+        fprintf(stderr, "dec_server error: failed to receive frame header\n");
+        close(connection_fd);
+        return 1;
+    }
+
+    // Key store frames have their own handlers; both leave the
+    // connection open for further pipelined frames
+    if (magic == (unsigned int)KEYSTORE_PUT_MAGIC) {
+        if (handle_keystore_put(connection_fd) != 0) {
+            close(connection_fd);
+            return 1;
+        }
+        continue;
+    }
+    if (magic == (unsigned int)KEYSTORE_REF_MAGIC) {
+        if (handle_keystore_ref(connection_fd) != 0) {
+            close(connection_fd);
+            return 1;
+        }
+        continue;
+    }
+    if (magic != (unsigned int)FRAME_MAGIC) {
+        fprintf(stderr, "dec_server error: unrecognized frame magic\n");
+        close(connection_fd);
+        return 1;
+    }
+
+    // An inline-key frame: the two lengths follow the magic
+    int lengths[2];
+    if (recv_full(connection_fd, lengths, sizeof(lengths)) < 0) {
+        fprintf(stderr, "dec_server error: failed to receive frame header\n");
+        close(connection_fd);
+        return 1;
+    }
+    int text_len = lengths[0];
+    int key_len = lengths[1];
+
+    // Validate the announced lengths
+    if (text_len <= 0 || key_len < text_len) {
+        fprintf(stderr, "dec_server error: invalid frame lengths\n");
+        close(connection_fd);
+        return 1;
+    }
+
+    // Allocate the working buffers
+    char *text = malloc(text_len);
+    char *key = malloc(text_len); // Only text_len key bytes are sent
+    char *result = malloc(text_len);
+    if (!text || !key || !result) {
+        fprintf(stderr, "dec_server error: memory allocation failed\n");
+        free(text);
+        free(key);
+        free(result);
+        close(connection_fd);
+        return 1;
+    }
+
+    // Receive the ciphertext, then the key
+    int total_received = 0;
+    while (total_received < text_len) {
+        ssize_t n = recv(connection_fd, text + total_received, text_len - total_received, 0);
+        if (n <= 0) {
+            fprintf(stderr, "dec_server error: failed to receive framed ciphertext\n");
+            free(text);
+            free(key);
+            free(result);
+            close(connection_fd);
+            return 1;
+        }
+        total_received += n;
+    }
+    total_received = 0;
+    while (total_received < text_len) {
+        ssize_t n = recv(connection_fd, key + total_received, text_len - total_received, 0);
+        if (n <= 0) {
+            fprintf(stderr, "dec_server error: failed to receive framed key\n");
+            free(text);
+            free(key);
+            free(result);
+            close(connection_fd);
+            return 1;
+        }
+        total_received += n;
+    }
+
+    // Process and reply with the bare result bytes
+    otp_decrypt(result, text, key, text_len);
+    int total_sent = 0;
+    while (total_sent < text_len) {
+        ssize_t n = send(connection_fd, result + total_sent, text_len - total_sent, 0);
+        if (n < 0) {
+            fprintf(stderr, "dec_server error: failed to send framed result\n");
+            break;
+        }
+        total_sent += n;
+    }
+
+    free(text);
+    free(key);
+    free(result);
+    if (total_sent < text_len) {
+        close(connection_fd);
+        return 1;
+    }
+    } // Next pipelined frame, if any
+}
 
 /**
  * @brief Handles communication with a connected client.
@@ -63,11 +515,24 @@
  * 3. Validates the lengths of ciphertext and key.
  * 4. Performs decryption using the one-time pad algorithm.
  * 5. Sends the decrypted plaintext back to the client.
- * 6. Cleans up resources and exits the child process.
+ * 6. Cleans up resources before returning, so it can serve one connection in a
+ *    forked child or be called repeatedly by a preforked worker.
  *
  * @param connection_fd File descriptor for the connected client socket.
+ * @return int 0 on success, nonzero on protocol or I/O failure.
  */
-void handle_client(int connection_fd) {
+int handle_client(int connection_fd) {
+    // A framed client leads with the magic instead of the identity string;
+    // peek so the legacy path still sees its ID bytes untouched
+    unsigned int magic = 0;
+    ssize_t peeked = recv(connection_fd, &magic, sizeof(magic), MSG_PEEK);
+    if (peeked == (ssize_t)sizeof(magic) &&
+        (magic == (unsigned int)FRAME_MAGIC ||
+         magic == (unsigned int)KEYSTORE_PUT_MAGIC ||
+         magic == (unsigned int)KEYSTORE_REF_MAGIC)) {
+        return handle_framed(connection_fd);
+    }
+
     // Authenticate Client
     char id_buffer[32];
     memset(id_buffer, 0, sizeof(id_buffer));
@@ -77,7 +542,7 @@ void handle_client(int connection_fd) {
     if (bytes_received <= 0) {
         fprintf(stderr, "dec_server error: failed to receive client ID\n");
         close(connection_fd);
-        exit(1);
+        return 1;
     }
     id_buffer[bytes_received] = '\0'; // Null-terminate the received string
 
@@ -87,7 +552,7 @@ void handle_client(int connection_fd) {
         send(connection_fd, error, strlen(error), 0);
         fprintf(stderr, "dec_server error: connected client is not dec_client\n");
         close(connection_fd);
-        exit(2);
+        return 2;
     }
 
     // Send acknowledgment to client
@@ -101,7 +566,7 @@ void handle_client(int connection_fd) {
         if (sent < 0) {
             fprintf(stderr, "dec_server error: failed to send acknowledgment\n");
             close(connection_fd);
-            exit(1);
+            return 1;
         }
         total_sent += sent;
     }
@@ -112,7 +577,12 @@ void handle_client(int connection_fd) {
     if (recv_ret < (ssize_t)sizeof(int)) {
         fprintf(stderr, "dec_server error: failed to receive ciphertext length\n");
         close(connection_fd);
-        exit(1);
+        return 1;
+    }
+
+    // The streaming sentinel selects the chunked protocol instead
+    if (ciphertext_len == STREAM_MODE_SENTINEL) {
+        return handle_stream(connection_fd);
     }
 
     // : Receive Key Length
@@ -121,14 +591,14 @@ void handle_client(int connection_fd) {
     if (recv_ret < (ssize_t)sizeof(int)) {
         fprintf(stderr, "dec_server error: failed to receive key length\n");
         close(connection_fd);
-        exit(1);
+        return 1;
     }
 
     // Validate key length
     if (key_len < ciphertext_len) {
         fprintf(stderr, "dec_server error: key length (%d) is less than ciphertext length (%d)\n", key_len, ciphertext_len);
         close(connection_fd);
-        exit(1);
+        return 1;
     }
 
     // Allocate Memory for Ciphertext and Key
@@ -137,7 +607,7 @@ void handle_client(int connection_fd) {
     if (!ciphertext || !key) {
         fprintf(stderr, "dec_server error: memory allocation failed\n");
         close(connection_fd);
-        exit(1);
+        return 1;
     }
 
     // Receive Ciphertext Data
@@ -149,7 +619,7 @@ void handle_client(int connection_fd) {
             free(ciphertext);
             free(key);
             close(connection_fd);
-            exit(1);
+            return 1;
         }
         total_received += n;
     }
@@ -164,7 +634,7 @@ void handle_client(int connection_fd) {
             free(ciphertext);
             free(key);
             close(connection_fd);
-            exit(1);
+            return 1;
         }
         total_received += n;
     }
@@ -177,34 +647,11 @@ void handle_client(int connection_fd) {
         free(ciphertext);
         free(key);
         close(connection_fd);
-        exit(1);
+        return 1;
     }
 
-    // Decrypt each character
-    for (int i = 0; i < ciphertext_len; i++) {
-        int c_val, k_val, p_val;
-
-        // Convert ciphertext character to numerical value
-        if (ciphertext[i] == ' ')
-            c_val = 26;
-        else
-            c_val = ciphertext[i] - 'A';
-
-        // Convert key character to numerical value
-        if (key[i] == ' ')
-            k_val = 26;
-        else
-            k_val = key[i] - 'A';
-
-        // Perform modular subtraction for decryption
-        p_val = (c_val - k_val + 27) % 27;
-
-        // Convert numerical value back to character
-        if (p_val == 26)
-            plaintext[i] = ' ';
-        else
-            plaintext[i] = 'A' + p_val;
-    }
+    // Decrypt using the shared one-time pad kernel (SIMD where available)
+    otp_decrypt(plaintext, ciphertext, key, ciphertext_len);
     plaintext[ciphertext_len] = '\0'; // Null-terminate plaintext
 
     // Send Plaintext Length to Client
@@ -228,7 +675,420 @@ void handle_client(int connection_fd) {
     free(key);
     free(plaintext);
     close(connection_fd);
-    exit(0); // Child process exits after handling client
+    return 0; // Connection handled; caller decides process fate
+}
+
+/* Event-Driven (epoll) Mode */
+
+#define EPOLL_MAX_EVENTS 64 // Events drained per epoll_wait call
+
+/**
+ * @brief States a connection moves through in epoll mode.
+ *
+ * These mirror the blocking sequence in handle_client(): read the identity,
+ * answer it, read the two lengths, read the payloads, send the result.
+ */
+typedef enum {
+    CONN_READ_ID,      // Waiting for the client identity string
+    CONN_SEND_ACK,     // Writing the acknowledgment (or rejection)
+    CONN_READ_LENGTHS, // Reading the text and key lengths
+    CONN_READ_PAYLOAD, // Reading the text, then the key
+    CONN_SEND_RESULT   // Writing the length-prefixed result
+} ConnState;
+
+/**
+ * @brief Per-connection context for epoll mode.
+ *
+ * One of these (plus its payload buffers) is all an idle connection costs,
+ * instead of a forked process and its address space. Progress counters let
+ * every state resume after a short read or write.
+ */
+typedef struct {
+    int fd;             // The connection socket (nonblocking)
+    ConnState state;    // Current position in the protocol
+    int reject;         // Set when the peer failed identity validation
+    int framed;         // Set when the peer used the framed handshake
+    const char *ack;    // Acknowledgment (or rejection) being sent
+    size_t ack_len;     // Total acknowledgment length
+    size_t ack_sent;    // Acknowledgment bytes already sent
+    char len_buf[2 * sizeof(int)]; // Accumulates the two length ints
+    size_t len_got;     // Length bytes received so far
+    int text_len;       // Payload length announced by the client
+    int key_len;        // Key length announced by the client
+    char *text;         // Payload buffer (text_len bytes)
+    char *key;          // Key buffer (text_len bytes used, like handle_client)
+    size_t text_got;    // Payload bytes received so far
+    size_t key_got;     // Key bytes received so far
+    char *result;       // Length-prefixed result being sent
+    size_t result_len;  // Total result length (prefix included)
+    size_t result_sent; // Result bytes already sent
+} Conn;
+
+/**
+ * @brief Tears down one epoll-mode connection and frees its buffers.
+ *
+ * @param epfd The epoll instance the connection is registered with.
+ * @param conn The connection to close.
+ */
+void conn_close(int epfd, Conn *conn) {
+    epoll_ctl(epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    free(conn->text);
+    free(conn->key);
+    free(conn->result);
+    free(conn);
+}
+
+/**
+ * @brief Switches the epoll interest for a connection between read and write.
+ *
+ * @param epfd     The epoll instance.
+ * @param conn     The connection to re-arm.
+ * @param events   EPOLLIN or EPOLLOUT.
+ *
+ * @return 0 on success, -1 if the connection was closed (and freed).
+ */
+int conn_rearm(int epfd, Conn *conn, uint32_t events) {
+    struct epoll_event ev;
+    ev.events = events;
+    ev.data.ptr = conn;
+    if (epoll_ctl(epfd, EPOLL_CTL_MOD, conn->fd, &ev) < 0) {
+        fprintf(stderr, "dec_server error: epoll_ctl failed\n");
+        conn_close(epfd, conn);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Advances one connection's state machine as far as the socket allows.
+ *
+ * Each state consumes or produces what it can and returns on EAGAIN; the
+ * next readiness event resumes exactly where it stopped. Reaching the end
+ * of CONN_SEND_RESULT (or any error) closes the connection.
+ *
+ * @param epfd The epoll instance.
+ * @param conn The connection to drive.
+ */
+void conn_drive(int epfd, Conn *conn) {
+    while (1) {
+        switch (conn->state) {
+        case CONN_READ_ID: {
+            // A framed client leads with the magic; peek so a legacy
+            // identity string is left in place for the branch below
+            unsigned int magic = 0;
+            ssize_t peeked = recv(conn->fd, &magic, sizeof(magic), MSG_PEEK);
+            if (peeked < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return; // Try again when readable
+            }
+            if (peeked == 0) {
+                conn_close(epfd, conn);
+                return;
+            }
+            if (peeked == (ssize_t)sizeof(magic) &&
+                (magic == (unsigned int)KEYSTORE_PUT_MAGIC ||
+                 magic == (unsigned int)KEYSTORE_REF_MAGIC)) {
+                // The key store does blocking disk work; serve it from
+                // the forking modes, not the event loop
+                fprintf(stderr, "dec_server error: key store frames are not served in epoll mode\n");
+                conn_close(epfd, conn);
+                return;
+            }
+            if (peeked == (ssize_t)sizeof(magic) &&
+                magic == (unsigned int)FRAME_MAGIC) {
+                // Consume the magic and fall through to the lengths; the
+                // magic authenticated the peer, so no ack is sent
+                recv(conn->fd, &magic, sizeof(magic), 0);
+                conn->framed = 1;
+                conn->state = CONN_READ_LENGTHS;
+                break;
+            }
+
+            // The identity arrives as one small send; read and check it
+            char id_buffer[32];
+            ssize_t n = recv(conn->fd, id_buffer, sizeof(id_buffer) - 1, 0);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return; // Try again when readable
+            }
+            if (n <= 0) {
+                conn_close(epfd, conn);
+                return;
+            }
+            id_buffer[n] = '\0';
+
+            if (strncmp(id_buffer, "dec_client", 10) != 0) {
+                conn->ack = "INVALID_CLIENT";
+                conn->reject = 1;
+            } else {
+                conn->ack = "DEC_SERVER_ACK";
+            }
+            conn->ack_len = strlen(conn->ack);
+            conn->state = CONN_SEND_ACK;
+            if (conn_rearm(epfd, conn, EPOLLOUT) < 0) return;
+            break;
+        }
+
+        case CONN_SEND_ACK: {
+            while (conn->ack_sent < conn->ack_len) {
+                ssize_t n = send(conn->fd, conn->ack + conn->ack_sent,
+                                 conn->ack_len - conn->ack_sent, 0);
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    return; // Try again when writable
+                }
+                if (n < 0) {
+                    conn_close(epfd, conn);
+                    return;
+                }
+                conn->ack_sent += n;
+            }
+            if (conn->reject) {
+                conn_close(epfd, conn); // Nothing more to say to an impostor
+                return;
+            }
+            conn->state = CONN_READ_LENGTHS;
+            if (conn_rearm(epfd, conn, EPOLLIN) < 0) return;
+            break;
+        }
+
+        case CONN_READ_LENGTHS: {
+            while (conn->len_got < sizeof(conn->len_buf)) {
+                ssize_t n = recv(conn->fd, conn->len_buf + conn->len_got,
+                                 sizeof(conn->len_buf) - conn->len_got, 0);
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    return; // Try again when readable
+                }
+                if (n <= 0) {
+                    conn_close(epfd, conn);
+                    return;
+                }
+                conn->len_got += n;
+            }
+            memcpy(&conn->text_len, conn->len_buf, sizeof(int));
+            memcpy(&conn->key_len, conn->len_buf + sizeof(int), sizeof(int));
+
+            // The streaming sentinel and bad lengths are not served here
+            if (conn->text_len <= 0 || conn->key_len < conn->text_len) {
+                fprintf(stderr, "dec_server error: invalid lengths in epoll mode\n");
+                conn_close(epfd, conn);
+                return;
+            }
+
+            conn->text = malloc(conn->text_len);
+            conn->key = malloc(conn->text_len); // Only text_len key bytes arrive
+            if (conn->text == NULL || conn->key == NULL) {
+                fprintf(stderr, "dec_server error: memory allocation failed\n");
+                conn_close(epfd, conn);
+                return;
+            }
+            conn->state = CONN_READ_PAYLOAD;
+            break;
+        }
+
+        case CONN_READ_PAYLOAD: {
+            // Fill the text buffer first, then the key buffer
+            while (conn->text_got < (size_t)conn->text_len) {
+                ssize_t n = recv(conn->fd, conn->text + conn->text_got,
+                                 conn->text_len - conn->text_got, 0);
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    return; // Try again when readable
+                }
+                if (n <= 0) {
+                    conn_close(epfd, conn);
+                    return;
+                }
+                conn->text_got += n;
+            }
+            while (conn->key_got < (size_t)conn->text_len) {
+                ssize_t n = recv(conn->fd, conn->key + conn->key_got,
+                                 conn->text_len - conn->key_got, 0);
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    return; // Try again when readable
+                }
+                if (n <= 0) {
+                    conn_close(epfd, conn);
+                    return;
+                }
+                conn->key_got += n;
+            }
+
+            // Everything is here: build the length-prefixed result in one
+            // buffer so sending needs a single resumable cursor
+            // A framed peer already knows the length, so its result is
+            // the bare bytes; legacy gets the length prefix as always
+            size_t prefix = conn->framed ? 0 : sizeof(int);
+            conn->result_len = prefix + (size_t)conn->text_len;
+            conn->result = malloc(conn->result_len);
+            if (conn->result == NULL) {
+                fprintf(stderr, "dec_server error: memory allocation failed\n");
+                conn_close(epfd, conn);
+                return;
+            }
+            if (!conn->framed) {
+                memcpy(conn->result, &conn->text_len, sizeof(int));
+            }
+            otp_decrypt(conn->result + prefix, conn->text, conn->key,
+                        conn->text_len);
+            conn->state = CONN_SEND_RESULT;
+            if (conn_rearm(epfd, conn, EPOLLOUT) < 0) return;
+            break;
+        }
+
+        case CONN_SEND_RESULT: {
+            while (conn->result_sent < conn->result_len) {
+                ssize_t n = send(conn->fd, conn->result + conn->result_sent,
+                                 conn->result_len - conn->result_sent, 0);
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    return; // Try again when writable
+                }
+                if (n < 0) {
+                    conn_close(epfd, conn);
+                    return;
+                }
+                conn->result_sent += n;
+            }
+            if (conn->framed) {
+                // A framed peer may pipeline another frame; reset and go
+                // back to reading (more data may already be buffered)
+                free(conn->text);
+                free(conn->key);
+                free(conn->result);
+                conn->text = conn->key = conn->result = NULL;
+                conn->text_got = conn->key_got = 0;
+                conn->len_got = 0;
+                conn->result_sent = conn->result_len = 0;
+                conn->framed = 0;
+                conn->state = CONN_READ_ID;
+                if (conn_rearm(epfd, conn, EPOLLIN) < 0) return;
+                break;
+            }
+            conn_close(epfd, conn); // Request complete
+            return;
+        }
+        }
+    }
+}
+
+/**
+ * @brief Runs the server as a single nonblocking process multiplexing all
+ *        connections through one epoll instance.
+ *
+ * Each connection is a Conn state machine driven by readiness events, so an
+ * idle socket costs a few hundred bytes of context instead of a forked
+ * process. This loop never returns.
+ *
+ * @param listen_fd The listening socket.
+ */
+void run_epoll_server(int listen_fd) {
+    // The listening socket must not block the event loop either
+    int flags = fcntl(listen_fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(listen_fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        fprintf(stderr, "dec_server error: cannot set listen socket nonblocking\n");
+        exit(1);
+    }
+
+    int epfd = epoll_create1(0);
+    if (epfd < 0) {
+        fprintf(stderr, "dec_server error: epoll_create1 failed\n");
+        exit(1);
+    }
+
+    // Register the listener; a NULL data pointer marks it in the event loop
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, listen_fd, &ev) < 0) {
+        fprintf(stderr, "dec_server error: epoll_ctl failed for listener\n");
+        exit(1);
+    }
+
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+    while (1) {
+        int n_ready = epoll_wait(epfd, events, EPOLL_MAX_EVENTS, -1);
+        if (n_ready < 0) {
+            if (errno == EINTR) {
+                continue; // Interrupted wait: retry
+            }
+            fprintf(stderr, "dec_server error: epoll_wait failed\n");
+            exit(1);
+        }
+
+        for (int i = 0; i < n_ready; i++) {
+            if (events[i].data.ptr == NULL) {
+                // Listener readable: accept everything currently queued
+                while (1) {
+                    struct sockaddr_in client_addr;
+                    socklen_t client_len = sizeof(client_addr);
+                    int connection_fd = accept(listen_fd,
+                                               (struct sockaddr *)&client_addr,
+                                               &client_len);
+                    if (connection_fd < 0) {
+                        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                            break; // Drained the accept queue
+                        }
+                        fprintf(stderr, "dec_server error: accept failed\n");
+                        break;
+                    }
+
+                    int cflags = fcntl(connection_fd, F_GETFL, 0);
+                    if (cflags < 0 ||
+                        fcntl(connection_fd, F_SETFL, cflags | O_NONBLOCK) < 0) {
+                        close(connection_fd);
+                        continue;
+                    }
+
+                    Conn *conn = calloc(1, sizeof(Conn));
+                    if (conn == NULL) {
+                        close(connection_fd);
+                        continue;
+                    }
+                    conn->fd = connection_fd;
+                    conn->state = CONN_READ_ID;
+
+                    struct epoll_event cev;
+                    cev.events = EPOLLIN;
+                    cev.data.ptr = conn;
+                    if (epoll_ctl(epfd, EPOLL_CTL_ADD, connection_fd, &cev) < 0) {
+                        close(connection_fd);
+                        free(conn);
+                        continue;
+                    }
+                }
+            } else {
+                // Connection readiness: push its state machine forward
+                conn_drive(epfd, (Conn *)events[i].data.ptr);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Connection loop run by each preforked worker process.
+ *
+ * Every worker blocks in accept() on the shared listening socket — the
+ * kernel load-balances incoming connections across the sleeping workers —
+ * and handles each accepted connection in place with handle_client().
+ * Compared to fork-per-connection this pays process creation once at
+ * startup instead of once per request.
+ *
+ * @param listen_fd The shared listening socket.
+ */
+void worker_loop(int listen_fd) {
+    while (1) {
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int connection_fd = accept(listen_fd, (struct sockaddr *)&client_addr, &client_len);
+        if (connection_fd < 0) {
+            if (errno == EINTR) {
+                continue; // Interrupted accept: retry
+            }
+            fprintf(stderr, "dec_server error: accept failed\n");
+            continue; // Keep serving despite a failed accept
+        }
+
+        // Handle the connection in this process; the return status only
+        // matters per connection, so the worker just moves to the next one
+        handle_client(connection_fd);
+    }
 }
 
 /**
@@ -264,8 +1124,8 @@ void reap_zombies(int signo) {
  */
 int main(int argc, char *argv[]) {
     //  Validate Command-Line Arguments
-    if (argc != 2) {
-        fprintf(stderr, "Usage: dec_server listening_port\n");
+    if (argc != 2 && argc != 3) {
+        fprintf(stderr, "Usage: dec_server listening_port [prefork_workers|epoll]\n");
         exit(1);
     }
 
@@ -276,6 +1136,22 @@ int main(int argc, char *argv[]) {
         exit(1);
     }
 
+    // Optional mode argument: "epoll" for the event-driven single process,
+    // or a preforked worker pool size (absent keeps fork-per-connection)
+    int prefork_workers = 0;
+    int epoll_mode = 0;
+    if (argc == 3) {
+        if (strcmp(argv[2], "epoll") == 0) {
+            epoll_mode = 1;
+        } else {
+            prefork_workers = atoi(argv[2]);
+            if (prefork_workers < 1 || prefork_workers > MAX_PREFORK_WORKERS) {
+                fprintf(stderr, "dec_server error: worker count must be 1-%d\n", MAX_PREFORK_WORKERS);
+                exit(1);
+            }
+        }
+    }
+
     // Set Up Signal Handler to Reap Zombies
     struct sigaction sa;
     sa.sa_handler = reap_zombies;        // Assign the signal handler function
@@ -323,6 +1199,32 @@ int main(int argc, char *argv[]) {
         exit(1);
     }
 
+    //  Event-Driven Mode: one nonblocking process multiplexes every
+    //  connection through epoll (never returns)
+    if (epoll_mode) {
+        run_epoll_server(listen_fd);
+    }
+
+    //  Prefork Mode: spawn the worker pool up front and let the kernel
+    //  balance accepts across it; the parent just keeps the pool's lead
+    if (prefork_workers > 0) {
+        for (int w = 0; w < prefork_workers; w++) {
+            pid_t pid = fork();
+            if (pid < 0) {
+                fprintf(stderr, "dec_server error: fork failed\n");
+                close(listen_fd);
+                exit(1);
+            } else if (pid == 0) {
+                worker_loop(listen_fd); // Workers serve connections forever
+            }
+        }
+
+        // Parent: sleep until signaled; dead workers are reaped by SIGCHLD
+        while (1) {
+            pause();
+        }
+    }
+
     //  Server Loop to Accept and Handle Connections
     while (1) {
         struct sockaddr_in client_addr;
@@ -342,7 +1244,7 @@ int main(int argc, char *argv[]) {
         } else if (pid == 0) {
             // Child Process: Handle the client
             close(listen_fd);          // Close the listening socket in the child
-            handle_client(connection_fd); // Process client communication
+            exit(handle_client(connection_fd)); // Process client communication, then exit
         } else {
             // Parent Process: Close the connected socket descriptor
             close(connection_fd);
@@ -26,7 +26,7 @@
  * ------
  * Run the client by specifying the plaintext file, key file, and server port:
  *
- *     ./enc_client <plaintext_file> <key_file> <server_port>
+ *     ./enc_client <plaintext_file> <key_file> <server_port> [stream]
  *
  * Example:
  *
@@ -46,11 +46,18 @@
 #include <ctype.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h> // Included for writev
 #include <netinet/in.h>
 #include <arpa/inet.h> // Included for inet_pton
 #include <netdb.h>
 
 #define BUFFER_SIZE 1024
+#define STREAM_CHUNK_SIZE 4096  // Payload bytes per streamed frame
+#define STREAM_MODE_SENTINEL -1 // Length value announcing the chunked protocol
+#define KEYSTORE_PUT_MAGIC 0x4B434E45 /* "ENCK" */ // Frame uploading a named key
+#define KEYSTORE_REF_MAGIC 0x52434E45 /* "ENCR" */ // Frame referencing a stored key
+#define BATCH_PIPELINE_WINDOW 8 // Framed requests in flight per batch connection
+#define FRAME_MAGIC 0x31434E45 /* "ENC1" little-endian, matches enc_server */
 
 /**
  * @brief Reads the content of a file into a dynamically allocated buffer.
@@ -116,6 +123,361 @@ char* read_file(const char *filename, int *length) {
     return buffer;
 }
 
+/**
+ * @brief Sends one framed request (header, plaintext, key) for a batch job.
+ *
+ * The whole frame goes out in a single writev, with short writes resubmitted.
+ *
+ * @param sockfd   Connected socket.
+ * @param text     The plaintext characters.
+ * @param text_len Number of plaintext characters.
+ * @param key      The key characters (at least text_len of them).
+ * @param key_len  Full key length, announced in the header.
+ * @return int 0 on success, -1 on send failure.
+ */
+int send_framed_request(int sockfd, char *text, int text_len, char *key, int key_len) {
+    int header[3];
+    header[0] = FRAME_MAGIC;
+    header[1] = text_len;
+    header[2] = key_len;
+
+    struct iovec iov[3];
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = text;
+    iov[1].iov_len = text_len;
+    iov[2].iov_base = key;
+    iov[2].iov_len = text_len; // Only text_len key bytes are sent
+    size_t frame_len = iov[0].iov_len + iov[1].iov_len + iov[2].iov_len;
+
+    ssize_t sent = writev(sockfd, iov, 3);
+    if (sent < 0) {
+        return -1;
+    }
+    // Resubmit whatever a short writev left behind
+    size_t frame_sent = (size_t)sent;
+    while (frame_sent < frame_len) {
+        size_t skip = frame_sent;
+        int v = 0;
+        while (skip >= iov[v].iov_len) {
+            skip -= iov[v].iov_len;
+            v++;
+        }
+        ssize_t n = send(sockfd, (char *)iov[v].iov_base + skip,
+                         iov[v].iov_len - skip, 0);
+        if (n < 0) {
+            return -1;
+        }
+        frame_sent += n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Reads one bare ciphertext of a known length and prints it.
+ *
+ * @param sockfd     Connected socket.
+ * @param result_len Number of result bytes the server will send.
+ * @return int 0 on success, -1 on receive failure.
+ */
+int read_framed_result(int sockfd, int result_len) {
+    char *result = malloc(result_len);
+    if (result == NULL) {
+        return -1;
+    }
+    size_t result_got = 0;
+    while (result_got < (size_t)result_len) {
+        ssize_t n = recv(sockfd, result + result_got, result_len - result_got, 0);
+        if (n <= 0) {
+            free(result);
+            return -1;
+        }
+        result_got += n;
+    }
+    fwrite(result, 1, result_len, stdout);
+    printf("\n");
+    free(result);
+    return 0;
+}
+
+/**
+ * @brief Opens a connection to the server on localhost.
+ *
+ * @param port Server port.
+ * @return int The connected socket; exits on failure.
+ */
+int connect_server(int port) {
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        fprintf(stderr, "enc_client error: cannot open socket\n");
+        exit(1);
+    }
+    struct sockaddr_in server_addr;
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, "127.0.0.1", &server_addr.sin_addr) <= 0) {
+        fprintf(stderr, "enc_client error: invalid address\n");
+        close(sockfd);
+        exit(1);
+    }
+    if (connect(sockfd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
+        fprintf(stderr, "Error: could not contact enc_server on port %d\n", port);
+        close(sockfd);
+        exit(2);
+    }
+    return sockfd;
+}
+
+/**
+ * @brief Uploads a key file to the server's named key store.
+ *
+ * Sends one frame — magic, name length, key length, name, key — and
+ * reads the int status back. After the upload, requests can reference
+ * the key by name and offset instead of retransmitting it.
+ *
+ * @param port     Server port on localhost.
+ * @param name     Name to store the key under.
+ * @param key_file Path to the key file to upload.
+ * @return int 0 on success; exits on failure.
+ */
+int run_keyput(int port, const char *name, const char *key_file) {
+    int key_len;
+    char *key = read_file((char *)key_file, &key_len);
+    int name_len = strlen(name);
+
+    int sockfd = connect_server(port);
+
+    int header[3];
+    header[0] = KEYSTORE_PUT_MAGIC;
+    header[1] = name_len;
+    header[2] = key_len;
+
+    struct iovec iov[3];
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = (char *)name;
+    iov[1].iov_len = name_len;
+    iov[2].iov_base = key;
+    iov[2].iov_len = key_len;
+    size_t frame_len = iov[0].iov_len + iov[1].iov_len + iov[2].iov_len;
+
+    ssize_t sent = writev(sockfd, iov, 3);
+    size_t frame_sent = sent < 0 ? 0 : (size_t)sent;
+    while (sent >= 0 && frame_sent < frame_len) {
+        size_t skip = frame_sent;
+        int v = 0;
+        while (skip >= iov[v].iov_len) {
+            skip -= iov[v].iov_len;
+            v++;
+        }
+        ssize_t n = send(sockfd, (char *)iov[v].iov_base + skip,
+                         iov[v].iov_len - skip, 0);
+        if (n < 0) {
+            sent = -1;
+            break;
+        }
+        frame_sent += n;
+    }
+    free(key);
+    if (sent < 0) {
+        fprintf(stderr, "enc_client error: failed to send key upload\n");
+        close(sockfd);
+        exit(1);
+    }
+
+    int status;
+    if (recv(sockfd, &status, sizeof(status), MSG_WAITALL) < (ssize_t)sizeof(status)) {
+        fprintf(stderr, "Error: could not contact enc_server on port %d\n", port);
+        close(sockfd);
+        exit(2);
+    }
+    close(sockfd);
+    if (status != 0) {
+        fprintf(stderr, "enc_client error: server rejected key '%s'\n", name);
+        exit(1);
+    }
+    return 0;
+}
+
+/**
+ * @brief Sends one plaintext referencing a stored key by name and offset.
+ *
+ * Only the plaintext crosses the wire; the server reads the key slice from
+ * its store. The reply is an int status, then the bare ciphertext on
+ * success, which prints to stdout followed by a newline.
+ *
+ * @param port      Server port on localhost.
+ * @param text_file Path to the plaintext file.
+ * @param name      Name of the stored key.
+ * @param offset    Byte offset into the stored key.
+ * @return int 0 on success; exits on failure.
+ */
+int run_keyref(int port, const char *text_file, const char *name, int offset) {
+    int text_len;
+    char *text = read_file((char *)text_file, &text_len);
+    int name_len = strlen(name);
+
+    int sockfd = connect_server(port);
+
+    int header[4];
+    header[0] = KEYSTORE_REF_MAGIC;
+    header[1] = text_len;
+    header[2] = name_len;
+    header[3] = offset;
+
+    struct iovec iov[3];
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = text;
+    iov[1].iov_len = text_len;
+    iov[2].iov_base = (char *)name;
+    iov[2].iov_len = name_len;
+    size_t frame_len = iov[0].iov_len + iov[1].iov_len + iov[2].iov_len;
+
+    ssize_t sent = writev(sockfd, iov, 3);
+    size_t frame_sent = sent < 0 ? 0 : (size_t)sent;
+    while (sent >= 0 && frame_sent < frame_len) {
+        size_t skip = frame_sent;
+        int v = 0;
+        while (skip >= iov[v].iov_len) {
+            skip -= iov[v].iov_len;
+            v++;
+        }
+        ssize_t n = send(sockfd, (char *)iov[v].iov_base + skip,
+                         iov[v].iov_len - skip, 0);
+        if (n < 0) {
+            sent = -1;
+            break;
+        }
+        frame_sent += n;
+    }
+    if (sent < 0) {
+        fprintf(stderr, "enc_client error: failed to send stored-key request\n");
+        free(text);
+        close(sockfd);
+        exit(1);
+    }
+
+    int status;
+    if (recv(sockfd, &status, sizeof(status), MSG_WAITALL) < (ssize_t)sizeof(status)) {
+        fprintf(stderr, "Error: could not contact enc_server on port %d\n", port);
+        free(text);
+        close(sockfd);
+        exit(2);
+    }
+    if (status != 0) {
+        fprintf(stderr, "enc_client error: server has no usable key '%s' at offset %d\n", name, offset);
+        free(text);
+        close(sockfd);
+        exit(1);
+    }
+    if (read_framed_result(sockfd, text_len) < 0) {
+        fprintf(stderr, "Error: could not contact enc_server on port %d\n", port);
+        free(text);
+        close(sockfd);
+        exit(2);
+    }
+    free(text);
+    close(sockfd);
+    return 0;
+}
+
+/**
+ * @brief Runs a batch of plaintext/key file pairs over one connection.
+ *
+ * Connects once, then pipelines framed requests: up to
+ * BATCH_PIPELINE_WINDOW frames are in flight before the oldest response
+ * is drained, so the connection stays busy in both directions without
+ * the two sides deadlocking on full socket buffers. Results print to
+ * stdout one per line, in input order.
+ *
+ * @param port   Server port on localhost.
+ * @param npairs Number of file pairs.
+ * @param files  Alternating plaintext and key file paths (2 * npairs entries).
+ * @return int 0 on success; exits on failure like the single-shot path.
+ */
+int run_batch(int port, int npairs, char *files[]) {
+    // Connect once for the whole batch
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        fprintf(stderr, "enc_client error: cannot open socket\n");
+        exit(1);
+    }
+    struct sockaddr_in server_addr;
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, "127.0.0.1", &server_addr.sin_addr) <= 0) {
+        fprintf(stderr, "enc_client error: invalid address\n");
+        close(sockfd);
+        exit(1);
+    }
+    if (connect(sockfd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
+        fprintf(stderr, "Error: could not contact enc_server on port %d\n", port);
+        close(sockfd);
+        exit(2);
+    }
+
+    // Lengths of requests sent but not yet answered, oldest first
+    int pending_len[BATCH_PIPELINE_WINDOW];
+    int pending_head = 0; // Next response to drain
+    int pending_tail = 0; // Next free slot
+    int outstanding = 0;
+
+    for (int i = 0; i < npairs; i++) {
+        int text_len;
+        char *text = read_file(files[2 * i], &text_len);
+        int key_len;
+        char *key = read_file(files[2 * i + 1], &key_len);
+        if (key_len < text_len) {
+            fprintf(stderr, "Error: key '%s' is too short\n", files[2 * i + 1]);
+            free(text);
+            free(key);
+            close(sockfd);
+            exit(1);
+        }
+
+        if (send_framed_request(sockfd, text, text_len, key, key_len) < 0) {
+            fprintf(stderr, "enc_client error: failed to send frame\n");
+            free(text);
+            free(key);
+            close(sockfd);
+            exit(1);
+        }
+        free(text);
+        free(key);
+        pending_len[pending_tail] = text_len;
+        pending_tail = (pending_tail + 1) % BATCH_PIPELINE_WINDOW;
+        outstanding++;
+
+        // Keep the pipeline from outrunning the socket buffers
+        if (outstanding == BATCH_PIPELINE_WINDOW) {
+            if (read_framed_result(sockfd, pending_len[pending_head]) < 0) {
+                fprintf(stderr, "Error: could not contact enc_server on port %d\n", port);
+                close(sockfd);
+                exit(2);
+            }
+            pending_head = (pending_head + 1) % BATCH_PIPELINE_WINDOW;
+            outstanding--;
+        }
+    }
+
+    // Drain the remaining responses in order
+    while (outstanding > 0) {
+        if (read_framed_result(sockfd, pending_len[pending_head]) < 0) {
+            fprintf(stderr, "Error: could not contact enc_server on port %d\n", port);
+            close(sockfd);
+            exit(2);
+        }
+        pending_head = (pending_head + 1) % BATCH_PIPELINE_WINDOW;
+        outstanding--;
+    }
+
+    close(sockfd);
+    return 0;
+}
+
 /**
  * @brief The main function initializes the client, connects to the server,
  *        sends plaintext and key data, receives encrypted ciphertext, and
@@ -137,10 +499,55 @@ char* read_file(const char *filename, int *length) {
  */
 int main(int argc, char *argv[]) {
     // Validate Command-Line Arguments
-    if (argc != 4) {
-        fprintf(stderr, "Usage: enc_client plaintext key port\n");
+    // Key store modes: upload a named key once, then reference it
+    if (argc >= 2 && strcmp(argv[1], "keyput") == 0) {
+        if (argc != 5) {
+            fprintf(stderr, "Usage: enc_client keyput port name keyfile\n");
+            exit(1);
+        }
+        int ks_port = atoi(argv[2]);
+        if (ks_port < 1024 || ks_port > 65535) {
+            fprintf(stderr, "enc_client error: invalid port number\n");
+            exit(1);
+        }
+        return run_keyput(ks_port, argv[3], argv[4]);
+    }
+    if (argc >= 2 && strcmp(argv[1], "keyref") == 0) {
+        if (argc != 5 && argc != 6) {
+            fprintf(stderr, "Usage: enc_client keyref port plaintext name [offset]\n");
+            exit(1);
+        }
+        int ks_port = atoi(argv[2]);
+        if (ks_port < 1024 || ks_port > 65535) {
+            fprintf(stderr, "enc_client error: invalid port number\n");
+            exit(1);
+        }
+        return run_keyref(ks_port, argv[3], argv[4], argc == 6 ? atoi(argv[5]) : 0);
+    }
+
+    // Batch mode: one connection, many pipelined framed requests
+    if (argc >= 2 && strcmp(argv[1], "batch") == 0) {
+        if (argc < 5 || (argc - 3) % 2 != 0) {
+            fprintf(stderr, "Usage: enc_client batch port plaintext1 key1 [plaintext2 key2 ...]\n");
+            exit(1);
+        }
+        int batch_port = atoi(argv[2]);
+        if (batch_port < 1024 || batch_port > 65535) {
+            fprintf(stderr, "enc_client error: invalid port number\n");
+            exit(1);
+        }
+        return run_batch(batch_port, (argc - 3) / 2, argv + 3);
+    }
+
+    if (argc != 4 &&
+        !(argc == 5 && (strcmp(argv[4], "stream") == 0 ||
+                        strcmp(argv[4], "framed") == 0))) {
+        fprintf(stderr, "Usage: enc_client plaintext key port [stream|framed]\n");
+        fprintf(stderr, "       enc_client batch port plaintext1 key1 [plaintext2 key2 ...]\n");
         exit(1);
     }
+    int stream_mode = (argc == 5 && strcmp(argv[4], "stream") == 0); // Chunked streaming protocol requested
+    int framed_mode = (argc == 5 && strcmp(argv[4], "framed") == 0); // Single-round-trip framed handshake
 
     char *plaintext_file = argv[1]; // Path to plaintext file
     char *key_file = argv[2];        // Path to key file
@@ -201,6 +608,87 @@ int main(int argc, char *argv[]) {
         exit(2);
     }
 
+    // Framed mode: the magic doubles as the identity, so the header and
+    // both payloads go out in one submission with no ack round trip; the
+    // only reply is the ciphertext itself (its length is already known)
+    if (framed_mode) {
+        int header[3];
+        header[0] = FRAME_MAGIC;
+        header[1] = plaintext_len;
+        header[2] = key_len;
+
+        struct iovec iov[3];
+        iov[0].iov_base = header;
+        iov[0].iov_len = sizeof(header);
+        iov[1].iov_base = plaintext;
+        iov[1].iov_len = plaintext_len;
+        iov[2].iov_base = key;
+        iov[2].iov_len = plaintext_len; // Only plaintext_len key bytes are sent
+        size_t frame_len = iov[0].iov_len + iov[1].iov_len + iov[2].iov_len;
+
+        ssize_t sent = writev(sockfd, iov, 3);
+        if (sent < 0) {
+            fprintf(stderr, "enc_client error: failed to send frame\n");
+            close(sockfd);
+            free(plaintext);
+            free(key);
+            exit(1);
+        }
+        // Resubmit whatever a short writev left behind
+        size_t frame_sent = (size_t)sent;
+        while (frame_sent < frame_len) {
+            size_t skip = frame_sent;
+            int v = 0;
+            while (skip >= iov[v].iov_len) {
+                skip -= iov[v].iov_len;
+                v++;
+            }
+            ssize_t n = send(sockfd, (char *)iov[v].iov_base + skip,
+                             iov[v].iov_len - skip, 0);
+            if (n < 0) {
+                fprintf(stderr, "enc_client error: failed to send frame\n");
+                close(sockfd);
+                free(plaintext);
+                free(key);
+                exit(1);
+            }
+            frame_sent += n;
+        }
+
+        // Receive the bare ciphertext bytes
+        char *result = malloc(plaintext_len);
+        if (result == NULL) {
+            fprintf(stderr, "enc_client error: memory allocation failed\n");
+            close(sockfd);
+            free(plaintext);
+            free(key);
+            exit(1);
+        }
+        size_t result_got = 0;
+        while (result_got < (size_t)plaintext_len) {
+            ssize_t n = recv(sockfd, result + result_got,
+                             plaintext_len - result_got, 0);
+            if (n <= 0) {
+                fprintf(stderr, "Error: could not contact enc_server on port %d\n", port);
+                free(result);
+                close(sockfd);
+                free(plaintext);
+                free(key);
+                exit(2);
+            }
+            result_got += n;
+        }
+
+        fwrite(result, 1, plaintext_len, stdout);
+        printf("\n");
+
+        free(result);
+        close(sockfd);
+        free(plaintext);
+        free(key);
+        return 0;
+    }
+
     // Send Client Identification
     char id_msg[] = "enc_client";                   // Identifier string for authentication
     size_t id_len = strlen(id_msg);
@@ -264,6 +752,92 @@ int main(int argc, char *argv[]) {
         exit(2);
     }
 
+    // Streaming mode: announce it, then ship the job in bounded frames so the
+    // server never has to hold more than one chunk of it in memory
+    if (stream_mode) {
+        int stream_flag = STREAM_MODE_SENTINEL;
+        if (send(sockfd, &stream_flag, sizeof(int), 0) < 0) {
+            fprintf(stderr, "enc_client error: failed to announce streaming mode\n");
+            close(sockfd);
+            free(plaintext);
+            free(key);
+            exit(1);
+        }
+
+        char chunk_result[STREAM_CHUNK_SIZE];
+        int offset = 0;
+        while (offset < plaintext_len) {
+            int chunk_len = plaintext_len - offset < STREAM_CHUNK_SIZE
+                          ? plaintext_len - offset : STREAM_CHUNK_SIZE;
+
+            // Frame: length, then the plaintext and key slices for this chunk
+            if (send(sockfd, &chunk_len, sizeof(int), 0) < 0) {
+                fprintf(stderr, "enc_client error: failed to send chunk length\n");
+                close(sockfd);
+                free(plaintext);
+                free(key);
+                exit(1);
+            }
+            size_t chunk_sent = 0;
+            while (chunk_sent < (size_t)chunk_len) {
+                ssize_t n = send(sockfd, plaintext + offset + chunk_sent, chunk_len - chunk_sent, 0);
+                if (n < 0) {
+                    fprintf(stderr, "enc_client error: failed to send chunk plaintext\n");
+                    close(sockfd);
+                    free(plaintext);
+                    free(key);
+                    exit(1);
+                }
+                chunk_sent += n;
+            }
+            chunk_sent = 0;
+            while (chunk_sent < (size_t)chunk_len) {
+                ssize_t n = send(sockfd, key + offset + chunk_sent, chunk_len - chunk_sent, 0);
+                if (n < 0) {
+                    fprintf(stderr, "enc_client error: failed to send chunk key\n");
+                    close(sockfd);
+                    free(plaintext);
+                    free(key);
+                    exit(1);
+                }
+                chunk_sent += n;
+            }
+
+            // The result comes back frame by frame; print it as it arrives
+            int chunk_received = 0;
+            while (chunk_received < chunk_len) {
+                ssize_t n = recv(sockfd, chunk_result + chunk_received, chunk_len - chunk_received, 0);
+                if (n <= 0) {
+                    fprintf(stderr, "enc_client error: failed to receive chunk result\n");
+                    close(sockfd);
+                    free(plaintext);
+                    free(key);
+                    exit(1);
+                }
+                chunk_received += n;
+            }
+            fwrite(chunk_result, 1, chunk_len, stdout);
+
+            offset += chunk_len;
+        }
+
+        // A zero-length frame ends the stream cleanly
+        int done = 0;
+        if (send(sockfd, &done, sizeof(int), 0) < 0) {
+            fprintf(stderr, "enc_client error: failed to send end-of-stream frame\n");
+            close(sockfd);
+            free(plaintext);
+            free(key);
+            exit(1);
+        }
+        printf("\n");
+
+        close(sockfd);
+        free(plaintext);
+        free(key);
+        return 0;
+    }
+
     // Send Plaintext Length
     if (send(sockfd, &plaintext_len, sizeof(int), 0) < 0) {
         fprintf(stderr, "enc_client error: failed to send plaintext length\n");
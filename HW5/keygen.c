@@ -8,11 +8,19 @@
  * encryption and decryption clients. The program ensures that the generated key is of the
  * specified length and outputs it to standard output followed by a newline.
  *
+ * Characters come from a xoshiro256** generator producing 64-bit blocks.
+ * Each block yields eight candidate bytes; a byte is accepted when it falls
+ * below 243 (the largest multiple of 27 that fits in a byte), so reducing it
+ * mod 27 is exactly uniform with no modulo bias. Accepted characters collect
+ * in a one-megabyte buffer flushed with write(), so generation runs at disk
+ * bandwidth rather than one putchar() call per character.
+ *
  * Features:
  * ---------
  * - Generates random keys composed of uppercase letters and spaces.
- * - Ensures reproducibility by seeding the random number generator with the current time
- *   and the process ID.
+ * - Bias-free mapping onto the 27-character set via rejection sampling.
+ * - Buffered bulk output in megabyte chunks for multi-gigabyte keys.
+ * - Seeds the generator from the current time and the process ID.
  * - Validates input to ensure that the key length is a positive integer.
  * - Handles potential output errors gracefully with informative messages.
  *
@@ -43,27 +51,82 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <time.h>
-#include <unistd.h> // Included for getpid()
+#include <unistd.h> // Included for getpid() and write()
+
+#define CHAR_SET_SIZE 27          // 26 letters + space
+#define ACCEPT_LIMIT 243          // Largest multiple of 27 below 256
+#define OUTPUT_BUFFER_SIZE (1 << 20) // One megabyte per write()
+
+// xoshiro256** state; seeded in main() before any characters are drawn
+static uint64_t prng_state[4];
+
+/**
+ * @brief Advances a splitmix64 sequence; used only to seed xoshiro256**.
+ *
+ * xoshiro's authors recommend seeding its state from a different generator
+ * so correlated seed words cannot land it in a weak region.
+ *
+ * @param x Pointer to the splitmix64 state, advanced in place.
+ * @return uint64_t The next seed word.
+ */
+uint64_t splitmix64_next(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
 
-#define CHAR_SET_SIZE 27 // 26 letters + space
+/**
+ * @brief Rotates a 64-bit value left by k bits.
+ *
+ * @param x The value to rotate.
+ * @param k The rotation count.
+ * @return uint64_t The rotated value.
+ */
+static inline uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
 
 /**
- * @brief Generates a random character from the defined character set.
+ * @brief Returns the next 64-bit block from the xoshiro256** generator.
  *
- * This function selects a random integer between 0 and 26 inclusive.
- * If the integer is 26, it returns a space character. Otherwise, it returns
- * the corresponding uppercase letter ('A' to 'Z').
+ * One call produces eight bytes of randomness, replacing eight rand()
+ * calls of the original implementation.
  *
- * @return char A randomly selected character (uppercase letter or space).
+ * @return uint64_t The next 64 random bits.
  */
-char get_random_char() {
-    int r = rand() % CHAR_SET_SIZE; // Generate a random number between 0 and 26
+uint64_t prng_next(void) {
+    uint64_t result = rotl64(prng_state[1] * 5, 7) * 9;
+    uint64_t t = prng_state[1] << 17;
+
+    prng_state[2] ^= prng_state[0];
+    prng_state[3] ^= prng_state[1];
+    prng_state[1] ^= prng_state[2];
+    prng_state[0] ^= prng_state[3];
+    prng_state[2] ^= t;
+    prng_state[3] = rotl64(prng_state[3], 45);
 
-    if (r == 26)
-        return ' '; // Return space if r is 26
-    else
-        return 'A' + r; // Return corresponding uppercase letter
+    return result;
+}
+
+/**
+ * @brief Writes a full buffer to standard output, retrying short writes.
+ *
+ * @param buffer The bytes to write.
+ * @param length Number of bytes to write.
+ */
+void write_all(const char *buffer, size_t length) {
+    size_t written = 0;
+    while (written < length) {
+        ssize_t n = write(STDOUT_FILENO, buffer + written, length - written);
+        if (n < 0) {
+            fprintf(stderr, "Error: failed to write key characters\n");
+            exit(1);
+        }
+        written += n;
+    }
 }
 
 /**
@@ -72,9 +135,10 @@ char get_random_char() {
  * It performs the following operations:
  * - Validates the number of command-line arguments.
  * - Converts the key length argument to an integer and validates it.
- * - Seeds the random number generator using the current time and process ID.
- * - Generates and outputs the random key character by character.
- * - Appends a newline character at the end of the key.
+ * - Seeds the xoshiro256** generator from the current time and process ID.
+ * - Draws 64-bit blocks, keeping each byte below ACCEPT_LIMIT and mapping
+ *   it mod 27 onto the character set (26 maps to space).
+ * - Flushes the output buffer in megabyte chunks, then appends a newline.
  *
  * @param argc Argument count.
  * @param argv Argument vector.
@@ -87,8 +151,9 @@ int main(int argc, char *argv[]) {
         exit(1);
     }
 
-    // Convert the key length argument to an integer
-    int keylength = atoi(argv[1]);
+    // Convert the key length argument to an integer (long long so
+    // multi-gigabyte keys are representable)
+    long long keylength = atoll(argv[1]);
 
     // Validate that the key length is a positive integer
     if (keylength < 1) {
@@ -96,25 +161,42 @@ int main(int argc, char *argv[]) {
         exit(1);
     }
 
-    // Seed the random number generator with current time XORed with process ID for uniqueness
-    srand(time(NULL) ^ getpid());
+    // Seed the generator: run time XOR pid through splitmix64 to fill
+    // all four state words
+    uint64_t seed = (uint64_t)time(NULL) ^ (uint64_t)getpid();
+    for (int i = 0; i < 4; i++) {
+        prng_state[i] = splitmix64_next(&seed);
+    }
+
+    // Generate into the buffer, flushing a megabyte at a time
+    static char buffer[OUTPUT_BUFFER_SIZE];
+    size_t filled = 0;
+    long long generated = 0;
+    while (generated < keylength) {
+        uint64_t block = prng_next();
 
-    // Generate and output the random key characters
-    for (int i = 0; i < keylength; i++) {
-        char c = get_random_char(); // Generate a random character
+        // Consume the block one byte at a time; bytes at or above
+        // ACCEPT_LIMIT are rejected so the mod 27 below is exactly uniform
+        for (int b = 0; b < 8 && generated < keylength; b++) {
+            unsigned int byte = (unsigned int)(block & 0xFF);
+            block >>= 8;
+            if (byte >= ACCEPT_LIMIT) {
+                continue;
+            }
+            unsigned int r = byte % CHAR_SET_SIZE;
+            buffer[filled++] = r == 26 ? ' ' : (char)('A' + r);
+            generated++;
 
-        // Output the generated character and handle potential output errors
-        if (putchar(c) == EOF) {
-            fprintf(stderr, "Error: failed to write key character\n");
-            exit(1);
+            if (filled == OUTPUT_BUFFER_SIZE) {
+                write_all(buffer, filled);
+                filled = 0;
+            }
         }
     }
 
-    // Append a newline character at the end of the key
-    if (putchar('\n') == EOF) {
-        fprintf(stderr, "Error: failed to write newline\n");
-        exit(1);
-    }
+    // Append the newline and flush whatever remains
+    buffer[filled++] = '\n';
+    write_all(buffer, filled);
 
     return 0; // Exit successfully
-}
\ No newline at end of file
+}
@@ -0,0 +1,220 @@
+/**
+ * otp_kernel.h
+ *
+ * Description:
+ * ------------
+ * Shared one-time pad character kernel used by enc_server and dec_server.
+ * Both servers work over the 27-character alphabet A-Z plus space, mapping
+ * space to the value 26, combining text and key values mod 27, and mapping
+ * the result back to a character.
+ *
+ * The kernels process 32 bytes (AVX2) or 16 bytes (SSE2) per step where the
+ * compiler targets those instruction sets, with a scalar loop finishing the
+ * tail (and handling everything on other targets). Because every value stays
+ * in 0..52, a single conditional subtract (or add) replaces the division:
+ *
+ *     encrypt: c = p + k;      if (c > 26) c -= 27;
+ *     decrypt: p = c - k;      if (p < 0)  p += 27;
+ *
+ * which vectorizes as a compare and a blend. The character<->value mapping
+ * (space <-> 26) is likewise a compare and a blend on each side.
+ *
+ * Author:
+ * -------
+ * Ethan Clinick
+ * CS374 HW5 FALL 2024
+ * 12/2/2024
+ */
+
+#ifndef OTP_KERNEL_H
+#define OTP_KERNEL_H
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Converts one ciphertext/plaintext/key character to its 0..26 value.
+ *
+ * @param ch The character ('A'-'Z' or ' ').
+ * @return int The character's one-time pad value.
+ */
+static inline int otp_char_to_val(char ch) {
+    return ch == ' ' ? 26 : ch - 'A';
+}
+
+/**
+ * @brief Converts a 0..26 value back to its character.
+ *
+ * @param val The one-time pad value.
+ * @return char The corresponding character ('A'-'Z' or ' ').
+ */
+static inline char otp_val_to_char(int val) {
+    return val == 26 ? ' ' : (char)('A' + val);
+}
+
+/**
+ * @brief Encrypts text with key using the one-time pad: out = (text + key) mod 27.
+ *
+ * All three buffers must hold at least len bytes; out may alias text.
+ *
+ * @param out  Destination for the ciphertext characters.
+ * @param text The plaintext characters.
+ * @param key  The key characters.
+ * @param len  Number of characters to process.
+ */
+static inline void otp_encrypt(char *out, const char *text, const char *key, int len) {
+    int i = 0;
+
+#if defined(__AVX2__)
+    const __m256i letter_a = _mm256_set1_epi8('A');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i v26 = _mm256_set1_epi8(26);
+    const __m256i v27 = _mm256_set1_epi8(27);
+
+    for (; i + 32 <= len; i += 32) {
+        __m256i t = _mm256_loadu_si256((const __m256i *)(text + i));
+        __m256i k = _mm256_loadu_si256((const __m256i *)(key + i));
+
+        /* Map characters to values: space becomes 26, letters become 0..25 */
+        __m256i tv = _mm256_blendv_epi8(_mm256_sub_epi8(t, letter_a), v26,
+                                        _mm256_cmpeq_epi8(t, space));
+        __m256i kv = _mm256_blendv_epi8(_mm256_sub_epi8(k, letter_a), v26,
+                                        _mm256_cmpeq_epi8(k, space));
+
+        /* Add and reduce mod 27 with one conditional subtract (sum <= 52) */
+        __m256i sum = _mm256_add_epi8(tv, kv);
+        sum = _mm256_blendv_epi8(sum, _mm256_sub_epi8(sum, v27),
+                                 _mm256_cmpgt_epi8(sum, v26));
+
+        /* Map values back to characters: 26 becomes space */
+        __m256i c = _mm256_blendv_epi8(_mm256_add_epi8(sum, letter_a), space,
+                                       _mm256_cmpeq_epi8(sum, v26));
+        _mm256_storeu_si256((__m256i *)(out + i), c);
+    }
+#elif defined(__SSE2__)
+    const __m128i letter_a = _mm_set1_epi8('A');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i v26 = _mm_set1_epi8(26);
+    const __m128i v27 = _mm_set1_epi8(27);
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i t = _mm_loadu_si128((const __m128i *)(text + i));
+        __m128i k = _mm_loadu_si128((const __m128i *)(key + i));
+
+        /* Map characters to values: space becomes 26, letters become 0..25
+           (SSE2 has no blendv, so blends are and/andnot/or) */
+        __m128i tsp = _mm_cmpeq_epi8(t, space);
+        __m128i tv = _mm_or_si128(_mm_andnot_si128(tsp, _mm_sub_epi8(t, letter_a)),
+                                  _mm_and_si128(tsp, v26));
+        __m128i ksp = _mm_cmpeq_epi8(k, space);
+        __m128i kv = _mm_or_si128(_mm_andnot_si128(ksp, _mm_sub_epi8(k, letter_a)),
+                                  _mm_and_si128(ksp, v26));
+
+        /* Add and reduce mod 27 with one conditional subtract (sum <= 52) */
+        __m128i sum = _mm_add_epi8(tv, kv);
+        __m128i over = _mm_cmpgt_epi8(sum, v26);
+        sum = _mm_sub_epi8(sum, _mm_and_si128(over, v27));
+
+        /* Map values back to characters: 26 becomes space */
+        __m128i is26 = _mm_cmpeq_epi8(sum, v26);
+        __m128i c = _mm_or_si128(_mm_andnot_si128(is26, _mm_add_epi8(sum, letter_a)),
+                                 _mm_and_si128(is26, space));
+        _mm_storeu_si128((__m128i *)(out + i), c);
+    }
+#endif
+
+    /* Scalar tail (and the whole buffer on non-SIMD builds) */
+    for (; i < len; i++) {
+        int sum = otp_char_to_val(text[i]) + otp_char_to_val(key[i]);
+        if (sum > 26) {
+            sum -= 27;
+        }
+        out[i] = otp_val_to_char(sum);
+    }
+}
+
+/**
+ * @brief Decrypts text with key using the one-time pad: out = (text - key) mod 27.
+ *
+ * All three buffers must hold at least len bytes; out may alias text.
+ *
+ * @param out  Destination for the plaintext characters.
+ * @param text The ciphertext characters.
+ * @param key  The key characters.
+ * @param len  Number of characters to process.
+ */
+static inline void otp_decrypt(char *out, const char *text, const char *key, int len) {
+    int i = 0;
+
+#if defined(__AVX2__)
+    const __m256i letter_a = _mm256_set1_epi8('A');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i v26 = _mm256_set1_epi8(26);
+    const __m256i v27 = _mm256_set1_epi8(27);
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (; i + 32 <= len; i += 32) {
+        __m256i t = _mm256_loadu_si256((const __m256i *)(text + i));
+        __m256i k = _mm256_loadu_si256((const __m256i *)(key + i));
+
+        /* Map characters to values: space becomes 26, letters become 0..25 */
+        __m256i tv = _mm256_blendv_epi8(_mm256_sub_epi8(t, letter_a), v26,
+                                        _mm256_cmpeq_epi8(t, space));
+        __m256i kv = _mm256_blendv_epi8(_mm256_sub_epi8(k, letter_a), v26,
+                                        _mm256_cmpeq_epi8(k, space));
+
+        /* Subtract and reduce mod 27 with one conditional add (diff >= -26) */
+        __m256i diff = _mm256_sub_epi8(tv, kv);
+        diff = _mm256_blendv_epi8(diff, _mm256_add_epi8(diff, v27),
+                                  _mm256_cmpgt_epi8(zero, diff));
+
+        /* Map values back to characters: 26 becomes space */
+        __m256i p = _mm256_blendv_epi8(_mm256_add_epi8(diff, letter_a), space,
+                                       _mm256_cmpeq_epi8(diff, v26));
+        _mm256_storeu_si256((__m256i *)(out + i), p);
+    }
+#elif defined(__SSE2__)
+    const __m128i letter_a = _mm_set1_epi8('A');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i v26 = _mm_set1_epi8(26);
+    const __m128i v27 = _mm_set1_epi8(27);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i t = _mm_loadu_si128((const __m128i *)(text + i));
+        __m128i k = _mm_loadu_si128((const __m128i *)(key + i));
+
+        /* Map characters to values: space becomes 26, letters become 0..25
+           (SSE2 has no blendv, so blends are and/andnot/or) */
+        __m128i tsp = _mm_cmpeq_epi8(t, space);
+        __m128i tv = _mm_or_si128(_mm_andnot_si128(tsp, _mm_sub_epi8(t, letter_a)),
+                                  _mm_and_si128(tsp, v26));
+        __m128i ksp = _mm_cmpeq_epi8(k, space);
+        __m128i kv = _mm_or_si128(_mm_andnot_si128(ksp, _mm_sub_epi8(k, letter_a)),
+                                  _mm_and_si128(ksp, v26));
+
+        /* Subtract and reduce mod 27 with one conditional add (diff >= -26) */
+        __m128i diff = _mm_sub_epi8(tv, kv);
+        __m128i neg = _mm_cmpgt_epi8(zero, diff);
+        diff = _mm_add_epi8(diff, _mm_and_si128(neg, v27));
+
+        /* Map values back to characters: 26 becomes space */
+        __m128i is26 = _mm_cmpeq_epi8(diff, v26);
+        __m128i p = _mm_or_si128(_mm_andnot_si128(is26, _mm_add_epi8(diff, letter_a)),
+                                 _mm_and_si128(is26, space));
+        _mm_storeu_si128((__m128i *)(out + i), p);
+    }
+#endif
+
+    /* Scalar tail (and the whole buffer on non-SIMD builds) */
+    for (; i < len; i++) {
+        int diff = otp_char_to_val(text[i]) - otp_char_to_val(key[i]);
+        if (diff < 0) {
+            diff += 27;
+        }
+        out[i] = otp_val_to_char(diff);
+    }
+}
+
+#endif /* OTP_KERNEL_H */
@@ -0,0 +1,124 @@
+/*
+* bench_time.c
+*
+* Benchmark driver: runs a command a fixed number of times, timing each
+* run with CLOCK_MONOTONIC, and emits one machine-readable CSV line with
+* latency percentiles and throughput. The child's stdout goes to
+* /dev/null (benchmarked programs may print megabytes) and its stdin
+* comes from the -i file, or /dev/null, so interactive programs can be
+* driven from a canned input.
+*
+* Usage: bench_time <label> <iters> <units> <unit_name> [-i infile] -- cmd [args...]
+*
+* Output line: label,iters,units,unit_name,p50_ms,p90_ms,p99_ms,units_per_sec
+* where units is the amount of work one run performs (rows, lines, bytes)
+* and units_per_sec is units divided by the mean run time.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char **environ;
+
+/* Compares two doubles for qsort. */
+static int cmpDouble(const void *a, const void *b) {
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+/* Returns the p-quantile (0..1) of a sorted array by nearest-rank. */
+static double percentile(const double *sorted, int n, double p) {
+    int idx = (int)(p * (n - 1) + 0.5);
+    return sorted[idx];
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 7) {
+        fprintf(stderr, "Usage: bench_time <label> <iters> <units> <unit_name> [-i infile] -- cmd [args...]\n");
+        return 1;
+    }
+    const char *label = argv[1];
+    int iters = atoi(argv[2]);
+    double units = atof(argv[3]);
+    const char *unitName = argv[4];
+    const char *inFile = "/dev/null";
+
+    int argi = 5;
+    if (strcmp(argv[argi], "-i") == 0) {
+        if (argi + 1 >= argc) {
+            fprintf(stderr, "bench_time: -i needs a file\n");
+            return 1;
+        }
+        inFile = argv[argi + 1];
+        argi += 2;
+    }
+    if (argi >= argc || strcmp(argv[argi], "--") != 0 || argi + 1 >= argc) {
+        fprintf(stderr, "bench_time: missing -- before the command\n");
+        return 1;
+    }
+    char **cmd = argv + argi + 1;
+    if (iters < 1 || iters > 10000) {
+        fprintf(stderr, "bench_time: iters must be 1..10000\n");
+        return 1;
+    }
+
+    double *ms = malloc(iters * sizeof(double));
+    if (ms == NULL) {
+        perror("malloc");
+        return 1;
+    }
+
+    double total = 0.0;
+    for (int i = 0; i < iters; i++) {
+        // Reopen stdin per run so every run reads the input from the start
+        int inFD = open(inFile, O_RDONLY);
+        int outFD = open("/dev/null", O_WRONLY);
+        if (inFD < 0 || outFD < 0) {
+            perror("open");
+            return 1;
+        }
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, inFD, 0);
+        posix_spawn_file_actions_adddup2(&actions, outFD, 1);
+
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        pid_t pid;
+        int err = posix_spawnp(&pid, cmd[0], &actions, NULL, cmd, environ);
+        if (err != 0) {
+            fprintf(stderr, "bench_time: cannot run %s\n", cmd[0]);
+            return 1;
+        }
+        int status;
+        waitpid(pid, &status, 0);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+
+        posix_spawn_file_actions_destroy(&actions);
+        close(inFD);
+        close(outFD);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "bench_time: %s failed on run %d\n", cmd[0], i + 1);
+            return 1;
+        }
+        ms[i] = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+        total += ms[i];
+    }
+
+    qsort(ms, iters, sizeof(double), cmpDouble);
+    double mean_s = total / iters / 1e3;
+    printf("%s,%d,%.0f,%s,%.3f,%.3f,%.3f,%.1f\n",
+           label, iters, units, unitName,
+           percentile(ms, iters, 0.50),
+           percentile(ms, iters, 0.90),
+           percentile(ms, iters, 0.99),
+           units / mean_s);
+    free(ms);
+    return 0;
+}
@@ -0,0 +1,46 @@
+/*
+* gen_lines.c
+*
+* Benchmark input generator: writes a line-stream input for the HW4 line
+* processor. Lines are random lengths of letters, spaces and '+' pairs
+* (so the plus-sign substitution path gets exercised), terminated by the
+* STOP line the processor expects. Seeded, so the same line count always
+* produces the same file.
+*
+* Usage: gen_lines <lines> <outfile>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: gen_lines <lines> <outfile>\n");
+        return 1;
+    }
+    long lines = atol(argv[1]);
+    if (lines < 1) {
+        fprintf(stderr, "gen_lines: lines must be positive\n");
+        return 1;
+    }
+    FILE *out = fopen(argv[2], "w");
+    if (out == NULL) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    srand(42); // Fixed seed: identical inputs across runs and commits
+    static const char charset[] = "abcdefghijklmnopqrstuvwxyz ++";
+    char line[121];
+    for (long i = 0; i < lines; i++) {
+        int len = 1 + rand() % 120;
+        for (int c = 0; c < len; c++) {
+            line[c] = charset[rand() % (int)(sizeof(charset) - 1)];
+        }
+        line[len] = '\0';
+        fprintf(out, "%s\n", line);
+    }
+    fprintf(out, "STOP\n");
+    fclose(out);
+    return 0;
+}
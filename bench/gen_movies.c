@@ -0,0 +1,56 @@
+/*
+* gen_movies.c
+*
+* Benchmark input generator: writes a movie CSV in the HW1 format
+* (Title,Year,Languages,Rating Value) with the requested number of rows.
+* Titles are unique, years span the range HW1 indexes, languages are a
+* random subset of a fixed list, and ratings are random to one decimal.
+* The generator is seeded so the same row count always produces the same
+* file, which keeps benchmark runs comparable across commits.
+*
+* Usage: gen_movies <rows> <outfile>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *LANGS[] = {
+    "English", "French", "Spanish", "German", "Japanese", "Korean",
+    "Mandarin", "Hindi", "Portuguese", "Italian", "Russian", "Arabic"
+};
+#define NUM_LANGS (int)(sizeof(LANGS) / sizeof(LANGS[0]))
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: gen_movies <rows> <outfile>\n");
+        return 1;
+    }
+    long rows = atol(argv[1]);
+    if (rows < 1) {
+        fprintf(stderr, "gen_movies: rows must be positive\n");
+        return 1;
+    }
+    FILE *out = fopen(argv[2], "w");
+    if (out == NULL) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    srand(42); // Fixed seed: identical inputs across runs and commits
+    fprintf(out, "Title,Year,Languages,Rating Value\n");
+    for (long i = 0; i < rows; i++) {
+        int year = 1900 + rand() % 122;
+        int nlangs = 1 + rand() % 4;
+        int rating10 = 10 + rand() % 91; // 1.0 .. 10.0
+
+        fprintf(out, "Movie %ld,%d,[", i, year);
+        int first = rand() % NUM_LANGS;
+        for (int l = 0; l < nlangs; l++) {
+            // Consecutive picks, so subsets repeat across rows
+            fprintf(out, "%s%s", l > 0 ? ";" : "", LANGS[(first + l) % NUM_LANGS]);
+        }
+        fprintf(out, "],%d.%d\n", rating10 / 10, rating10 % 10);
+    }
+    fclose(out);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#!/bin/bash
+# run_bench.sh
+#
+# Runs the repo benchmark suite and writes machine-readable results to
+# bench/results.csv (one CSV line per benchmark, header first). Expects
+# the programs and bench tools to be built already; `make bench` at the
+# repo root does both. Sizes are chosen so the whole suite finishes in
+# about a minute on one core.
+
+cd "$(dirname "$0")" || exit 1
+
+OUT=results.csv
+MOVIE_ROWS=200000
+LINE_COUNT=200000
+OTP_BYTES=1048576
+ENC_PORT=57991
+DEC_PORT=57992
+
+fail() { echo "run_bench.sh: $1" >&2; exit 1; }
+
+echo "label,iters,units,unit_name,p50_ms,p90_ms,p99_ms,units_per_sec" > $OUT
+
+# --- HW1: CSV ingest (rows/sec) ---
+./gen_movies $MOVIE_ROWS bench_movies.csv || fail "gen_movies"
+printf '4\n' > bench_menu_exit.txt
+# Cold runs re-parse the CSV every time (the snapshot is removed per run)
+./bench_time hw1_ingest_cold 3 $MOVIE_ROWS rows -i bench_menu_exit.txt -- \
+    sh -c 'rm -f bench_movies.csv.snap; exec ../HW1/movies bench_movies.csv' >> $OUT || fail "hw1 cold"
+# Warm runs load the snapshot a prior run wrote
+../HW1/movies bench_movies.csv < bench_menu_exit.txt > /dev/null || fail "hw1 prime"
+./bench_time hw1_ingest_warm 5 $MOVIE_ROWS rows -i bench_menu_exit.txt -- \
+    ../HW1/movies bench_movies.csv >> $OUT || fail "hw1 warm"
+
+# --- HW4: line pipeline (lines/sec) ---
+./gen_lines $LINE_COUNT bench_lines.txt || fail "gen_lines"
+./bench_time hw4_pipeline_1w 3 $LINE_COUNT lines -i bench_lines.txt -- \
+    ../HW4/lineprocessor 1 >> $OUT || fail "hw4 1w"
+./bench_time hw4_pipeline_4w 3 $LINE_COUNT lines -i bench_lines.txt -- \
+    ../HW4/lineprocessor 4 >> $OUT || fail "hw4 4w"
+
+# --- HW5: one-time pad encrypt/decrypt (bytes/sec, per-request latency) ---
+../HW5/keygen $OTP_BYTES > bench_pt.txt || fail "keygen pt"
+../HW5/keygen $((OTP_BYTES * 2)) > bench_key.txt || fail "keygen key"
+../HW5/enc_server $ENC_PORT 2 & ENC_PID=$!
+../HW5/dec_server $DEC_PORT 2 & DEC_PID=$!
+sleep 0.5
+./bench_time hw5_encrypt 10 $OTP_BYTES bytes -- \
+    ../HW5/enc_client bench_pt.txt bench_key.txt $ENC_PORT framed >> $OUT || fail "hw5 enc"
+../HW5/enc_client bench_pt.txt bench_key.txt $ENC_PORT framed > bench_ct.txt || fail "hw5 ct"
+./bench_time hw5_decrypt 10 $OTP_BYTES bytes -- \
+    ../HW5/dec_client bench_ct.txt bench_key.txt $DEC_PORT framed >> $OUT || fail "hw5 dec"
+kill $ENC_PID $DEC_PID 2> /dev/null
+wait $ENC_PID $DEC_PID 2> /dev/null
+
+rm -f bench_movies.csv bench_movies.csv.snap bench_menu_exit.txt \
+      bench_lines.txt bench_pt.txt bench_key.txt bench_ct.txt
+
+cat $OUT